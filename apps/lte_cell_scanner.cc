@@ -0,0 +1,376 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Offline cell scanner for recorded IQ files.
+ *
+ * The file is memory mapped and cut into chunks of a few frames. Worker
+ * threads search each chunk for cells with cell_search and decode the MIB
+ * of every cell found with mib_decoder. The results of all chunks are
+ * merged per cell ID and printed, strongest cells first.
+ */
+
+#include <lte/cell_search.h>
+#include <lte/mib_decoder.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+  enum sample_format { FORMAT_CF32, FORMAT_CI16 };
+
+  struct options
+  {
+    std::string filename;
+    sample_format format;
+    int fftl;
+    int chunk_ms;
+    int nthreads;
+    int max_cells;
+  };
+
+  // a cell found in one chunk and its MIB, if any frame of the chunk decoded
+  struct chunk_cell
+  {
+    gr::lte::cell_info cell;
+    bool has_mib;
+    gr::lte::mib_info mib;
+  };
+
+  // all chunks a cell was found in
+  struct cell_summary
+  {
+    int n_chunks;
+    int n_mibs;
+    long first_chunk;
+    double snr_sum;
+    double cfo_sum;
+    float max_snr;
+    gr::lte::mib_info mib;
+  };
+
+  /*
+   * Chunks are handed out one by one. Each worker owns its cell_search
+   * and mib_decoder, they are created before the threads start as FFTW
+   * planning is not thread safe.
+   */
+  class scanner
+  {
+  public:
+    scanner(const options &opt, const char* data, long nsamples) :
+        d_opt(opt), d_data(data), d_nsamples(nsamples), d_next_chunk(0)
+    {
+      d_frame_len = 150L * opt.fftl;
+      d_chunk_len = d_frame_len * opt.chunk_ms / 10;
+      d_nchunks = nsamples >= d_chunk_len ? nsamples / d_chunk_len : (nsamples > 0 ? 1 : 0);
+      d_results.resize(d_nchunks);
+      for(int i = 0; i < opt.nthreads; i++){
+        d_search.push_back(new gr::lte::cell_search(opt.fftl, opt.max_cells));
+        d_mib.push_back(new gr::lte::mib_decoder(opt.fftl));
+      }
+    }
+
+    ~scanner()
+    {
+      for(unsigned int i = 0; i < d_search.size(); i++){
+        delete d_search[i];
+        delete d_mib[i];
+      }
+    }
+
+    void run()
+    {
+      boost::thread_group threads;
+      for(int id = 1; id < d_opt.nthreads; id++){
+        threads.create_thread(boost::bind(&scanner::worker, this, id));
+      }
+      worker(0);
+      threads.join_all();
+    }
+
+    long nchunks() const { return d_nchunks; }
+    long chunk_len() const { return d_chunk_len; }
+    const std::vector<chunk_cell> &results(long chunk) const { return d_results[chunk]; }
+
+  private:
+    options d_opt;
+    const char* d_data;
+    long d_nsamples;
+    long d_frame_len;
+    long d_chunk_len;
+    long d_nchunks;
+
+    gr::thread::mutex d_mutex;
+    long d_next_chunk;
+
+    std::vector<gr::lte::cell_search*> d_search;
+    std::vector<gr::lte::mib_decoder*> d_mib;
+    std::vector<std::vector<chunk_cell> > d_results;
+
+    void worker(int id)
+    {
+      std::vector<gr_complex> buf;
+      while(true){
+        long chunk;
+        {
+          gr::thread::scoped_lock lock(d_mutex);
+          if(d_next_chunk >= d_nchunks){
+            return;
+          }
+          chunk = d_next_chunk++;
+        }
+        const long start = chunk * d_chunk_len;
+        // the last chunk takes the remainder of the file
+        const long len = chunk == d_nchunks - 1 ? d_nsamples - start : d_chunk_len;
+        process_chunk(id, chunk, samples(buf, start, len), len);
+      }
+    }
+
+    const gr_complex* samples(std::vector<gr_complex> &buf, long start, long len)
+    {
+      if(d_opt.format == FORMAT_CF32){
+        return reinterpret_cast<const gr_complex*>(d_data) + start;
+      }
+      const int16_t* in = reinterpret_cast<const int16_t*>(d_data) + 2 * start;
+      buf.resize(len);
+      for(long i = 0; i < len; i++){
+        buf[i] = gr_complex(in[2 * i], in[2 * i + 1]) * (1.0f / 32768.0f);
+      }
+      return &buf[0];
+    }
+
+    void process_chunk(int id, long chunk, const gr_complex* in, long len)
+    {
+      std::vector<gr::lte::cell_info> cells = d_search[id]->search(in, int(len));
+      gr::lte::mib_decoder* dec = d_mib[id];
+      std::vector<chunk_cell> &res = d_results[chunk];
+
+      for(unsigned int c = 0; c < cells.size(); c++){
+        chunk_cell cc;
+        cc.cell = cells[c];
+        cc.has_mib = false;
+        // the first frame of the chunk with a valid CRC
+        for(long f = cells[c].frame_start; f + dec->samples_needed() <= len; f += d_frame_len){
+          if(dec->decode(cc.mib, in + f, cells[c].cell_id, cells[c].cfo)){
+            cc.has_mib = true;
+            break;
+          }
+        }
+        res.push_back(cc);
+      }
+    }
+  };
+
+  void
+  usage(const char* name)
+  {
+    fprintf(stderr,
+            "usage: %s [options] file\n"
+            "Searches a recording at fftl * 15 kHz for LTE cells and decodes their MIB.\n"
+            "  -f cf32|ci16  sample format, default from the file extension, else cf32\n"
+            "  -l fftl       FFT length, a multiple of 128 (default 128, 1.92 MSps)\n"
+            "  -c ms         chunk length in ms, at least 20 (default 40)\n"
+            "  -t n          worker threads (default all cores)\n"
+            "  -n n          maximum PSS candidates per N_id_2 and chunk (default 8)\n",
+            name);
+  }
+
+  bool
+  parse_options(options &opt, int argc, char** argv)
+  {
+    opt.format = FORMAT_CF32;
+    opt.fftl = 128;
+    opt.chunk_ms = 40;
+    opt.nthreads = std::max(1, int(boost::thread::hardware_concurrency()));
+    opt.max_cells = 8;
+    bool format_set = false;
+
+    int c;
+    while((c = getopt(argc, argv, "f:l:c:t:n:h")) != -1){
+      switch(c){
+        case 'f':
+          if(strcmp(optarg, "cf32") == 0){
+            opt.format = FORMAT_CF32;
+          }
+          else if(strcmp(optarg, "ci16") == 0){
+            opt.format = FORMAT_CI16;
+          }
+          else{
+            return false;
+          }
+          format_set = true;
+          break;
+        case 'l': opt.fftl = atoi(optarg); break;
+        case 'c': opt.chunk_ms = atoi(optarg); break;
+        case 't': opt.nthreads = atoi(optarg); break;
+        case 'n': opt.max_cells = atoi(optarg); break;
+        default: return false;
+      }
+    }
+    if(optind != argc - 1 || opt.fftl < 128 || opt.fftl % 128 != 0
+       || opt.chunk_ms < 20 || opt.nthreads < 1 || opt.max_cells < 1){
+      return false;
+    }
+    opt.filename = argv[optind];
+
+    const std::string::size_type dot = opt.filename.rfind('.');
+    if(!format_set && dot != std::string::npos && opt.filename.substr(dot) == ".ci16"){
+      opt.format = FORMAT_CI16;
+    }
+    return true;
+  }
+
+  double
+  now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+  }
+
+  bool
+  stronger(const std::pair<int, cell_summary> &a, const std::pair<int, cell_summary> &b)
+  {
+    if(a.second.n_chunks != b.second.n_chunks){
+      return a.second.n_chunks > b.second.n_chunks;
+    }
+    return a.second.snr_sum > b.second.snr_sum;
+  }
+
+} // anonymous namespace
+
+int
+main(int argc, char** argv)
+{
+  options opt;
+  if(!parse_options(opt, argc, argv)){
+    usage(argv[0]);
+    return 1;
+  }
+
+  int fd = open(opt.filename.c_str(), O_RDONLY);
+  if(fd < 0){
+    perror(opt.filename.c_str());
+    return 1;
+  }
+  struct stat st;
+  if(fstat(fd, &st) != 0){
+    perror(opt.filename.c_str());
+    close(fd);
+    return 1;
+  }
+  const long sample_size = opt.format == FORMAT_CF32 ? sizeof(gr_complex) : 2 * sizeof(int16_t);
+  const long nsamples = st.st_size / sample_size;
+  if(nsamples == 0){
+    fprintf(stderr, "%s: no samples\n", opt.filename.c_str());
+    close(fd);
+    return 1;
+  }
+  void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED){
+    perror("mmap");
+    return 1;
+  }
+  madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+  const double samp_rate = opt.fftl * 15e3;
+  double t_start = now();
+  long nchunks;
+  std::map<int, cell_summary> cells;
+  {
+    scanner sc(opt, static_cast<const char*>(map), nsamples);
+    sc.run();
+    nchunks = sc.nchunks();
+
+    // merge in chunk order, thus the reported MIB is the first one decoded
+    for(long chunk = 0; chunk < nchunks; chunk++){
+      const std::vector<chunk_cell> &res = sc.results(chunk);
+      for(unsigned int i = 0; i < res.size(); i++){
+        const chunk_cell &cc = res[i];
+        std::map<int, cell_summary>::iterator it = cells.find(cc.cell.cell_id);
+        if(it == cells.end()){
+          cell_summary s;
+          s.n_chunks = 0;
+          s.n_mibs = 0;
+          s.first_chunk = chunk;
+          s.snr_sum = 0.0;
+          s.cfo_sum = 0.0;
+          s.max_snr = cc.cell.snr;
+          it = cells.insert(std::make_pair(cc.cell.cell_id, s)).first;
+        }
+        cell_summary &s = it->second;
+        s.n_chunks++;
+        s.snr_sum += cc.cell.snr;
+        s.cfo_sum += cc.cell.cfo;
+        s.max_snr = std::max(s.max_snr, cc.cell.snr);
+        if(cc.has_mib){
+          if(s.n_mibs == 0){
+            s.mib = cc.mib;
+          }
+          s.n_mibs++;
+        }
+      }
+    }
+
+    const double t_proc = now() - t_start;
+    const double duration = nsamples / samp_rate;
+    fprintf(stderr, "%s: %.3f s of samples in %ld chunks, %.2f s with %d threads (%.1fx real time)\n",
+            opt.filename.c_str(), duration, nchunks, t_proc, opt.nthreads,
+            t_proc > 0.0 ? duration / t_proc : 0.0);
+
+    std::vector<std::pair<int, cell_summary> > sorted(cells.begin(), cells.end());
+    std::sort(sorted.begin(), sorted.end(), stronger);
+
+    printf("cell_id  chunks  snr[dB]  max[dB]  cfo[Hz]  first[s]  mibs  N_ant  N_rb_dl  phich_dur  phich_res  SFN\n");
+    for(unsigned int i = 0; i < sorted.size(); i++){
+      const cell_summary &s = sorted[i].second;
+      printf("%7d  %6d  %7.1f  %7.1f  %7.0f  %8.2f  %4d",
+             sorted[i].first, s.n_chunks, s.snr_sum / s.n_chunks, s.max_snr,
+             s.cfo_sum / s.n_chunks, s.first_chunk * sc.chunk_len() / samp_rate, s.n_mibs);
+      if(s.n_mibs > 0){
+        printf("  %5d  %7d  %9s  %9.3f  %3d\n", s.mib.N_ant, s.mib.N_rb_dl,
+               s.mib.phich_duration ? "extended" : "normal", s.mib.phich_resources, s.mib.sfn);
+      }
+      else{
+        printf("  %5s  %7s  %9s  %9s  %3s\n", "-", "-", "-", "-", "-");
+      }
+    }
+  }
+
+  munmap(map, st.st_size);
+  return 0;
+}
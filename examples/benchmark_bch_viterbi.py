@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Compare BCH codewords per second of the native Viterbi block
+# against the gr-trellis based hier block.
+
+from gnuradio import gr, blocks
+from optparse import OptionParser
+import lte
+import time
+import random
+
+
+def encode(bits):
+    # LTE tail-biting convolutional encoder, 36.212 5.1.3.1
+    reg = bits[-6:][::-1]
+    out = []
+    for b in bits:
+        out.append((b + reg[1] + reg[2] + reg[4] + reg[5]) % 2)
+        out.append((b + reg[0] + reg[1] + reg[2] + reg[5]) % 2)
+        out.append((b + reg[0] + reg[1] + reg[3] + reg[5]) % 2)
+        reg = [b] + reg[:5]
+    return out
+
+
+def get_codewords(n_codewords, sigma):
+    data = []
+    for i in range(n_codewords):
+        bits = [random.randint(0, 1) for b in range(40)]
+        data.extend([1.0 - 2.0 * c + random.gauss(0.0, sigma) for c in encode(bits)])
+    return data
+
+
+def run_decoder(decoder, data, n_codewords):
+    tb = gr.top_block()
+    src = blocks.vector_source_f(data, True, 120)
+    head = blocks.head(gr.sizeof_float * 120, n_codewords)
+    snk = blocks.null_sink(gr.sizeof_char * 40)
+    tb.connect(src, head, decoder, snk)
+
+    start = time.time()
+    tb.run()
+    return n_codewords / (time.time() - start)
+
+
+def main():
+    parser = OptionParser()
+    parser.add_option("-N", "--codewords", type="int", default=100000,
+                      help="number of codewords to decode [default=%default]")
+    parser.add_option("-s", "--sigma", type="float", default=0.3,
+                      help="noise standard deviation of soft values [default=%default]")
+    (options, args) = parser.parse_args()
+
+    data = get_codewords(100, options.sigma)
+
+    decoders = [("bch_viterbi_vfvb", lambda: lte.bch_viterbi_vfvb()),
+                ("bch_viterbi_vfvb (WAVA)", lambda: lte.bch_viterbi_vfvb(True, 4)),
+                ("bch_viterbi_trellis_vfvb", lambda: lte.bch_viterbi_trellis_vfvb())]
+    for name, make in decoders:
+        rate = run_decoder(make(), data, options.codewords)
+        print "%-26s %10.0f codewords/s" % (name, rate)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,77 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Measure channel estimator throughput in subcarriers per symbol per second
+# for magnitude/phase and complex interpolation.
+
+from gnuradio import gr, blocks
+from optparse import OptionParser
+import lte
+import time
+import random
+
+
+def run_estimator(estimator, data, subcarriers, rxant, n_symbols):
+    vlen = subcarriers * rxant
+    tb = gr.top_block()
+    src = blocks.vector_source_c(data, True, vlen)
+    head = blocks.head(gr.sizeof_gr_complex * vlen, n_symbols)
+    snk = blocks.null_sink(gr.sizeof_gr_complex * vlen)
+    tb.connect(src, head, estimator, snk)
+
+    start = time.time()
+    tb.run()
+    return n_symbols * subcarriers * rxant / (time.time() - start)
+
+
+def main():
+    parser = OptionParser()
+    parser.add_option("-r", "--N-rb-dl", type="int", default=100,
+                      help="number of resource blocks [default=%default]")
+    parser.add_option("-a", "--rxant", type="int", default=4,
+                      help="number of RX antennas [default=%default]")
+    parser.add_option("-N", "--symbols", type="int", default=140 * 200,
+                      help="number of OFDM symbols [default=%default]")
+    (options, args) = parser.parse_args()
+
+    N_rb_dl = options.N_rb_dl
+    rxant = options.rxant
+    subcarriers = 12 * N_rb_dl
+    cell_id = 124
+    Ncp = 1
+
+    [pilot_carriers, pilot_symbols] = lte.frame_pilot_value_and_position(N_rb_dl, cell_id, Ncp, 0)
+    data = [complex(random.gauss(0, 1), random.gauss(0, 1)) for i in range(subcarriers * rxant * 140)]
+
+    print "N_rb_dl = %i, rxant = %i" % (N_rb_dl, rxant)
+    for name, complex_interp in [("magnitude/phase", False), ("complex", True)]:
+        estimator = lte.channel_estimator_vcvc(rxant, subcarriers, "symbol", "pilots",
+                                               pilot_carriers, pilot_symbols, "estimator",
+                                               complex_interp)
+        rate = run_estimator(estimator, data, subcarriers, rxant, options.symbols)
+        print "%-16s %8.2f Msubcarriers/s" % (name, rate * 1e-6)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
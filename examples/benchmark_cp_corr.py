@@ -0,0 +1,90 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+# Measure CP correlations per second of rough_symbol_sync_cc and
+# sync_frequency_c. Growth of the peak resident memory between two runs
+# shows heap allocations in work(), it stays at 0 kB without them.
+
+from gnuradio import gr, blocks, analog
+from optparse import OptionParser
+import lte
+import time
+import random
+import resource
+
+
+def max_rss_kb():
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+
+
+def get_samples(n):
+    return [complex(random.gauss(0, 1), random.gauss(0, 1)) for i in range(n)]
+
+
+def run_sync_frequency(fftl, n_samples):
+    slotl = 7 * fftl + 6 * (144 * fftl // 2048) + 160 * fftl // 2048
+    tb = gr.top_block()
+    src = blocks.vector_source_c(get_samples(slotl * 20), True)
+    head = blocks.head(gr.sizeof_gr_complex, n_samples)
+    sig = analog.sig_source_c(slotl * 2000, analog.GR_COS_WAVE, 0, 1)
+    sync = lte.sync_frequency_c(sig, fftl)
+    tb.connect(src, head, sync)
+
+    start = time.time()
+    tb.run()
+    # 7 CP correlations per slot
+    return 7 * (n_samples // slotl) / (time.time() - start)
+
+
+def run_rough_symbol_sync(fftl, n_samples):
+    tb = gr.top_block()
+    src = blocks.vector_source_c(get_samples(100000), True)
+    head = blocks.head(gr.sizeof_gr_complex, n_samples)
+    sync = lte.rough_symbol_sync_cc(fftl, 1)
+    snk = blocks.null_sink(gr.sizeof_gr_complex)
+    tb.connect(src, head, sync, snk)
+
+    start = time.time()
+    tb.run()
+    # one CP correlation window per sample, updated recursively
+    return n_samples / (time.time() - start)
+
+
+def main():
+    parser = OptionParser()
+    parser.add_option("-N", "--samples", type="int", default=10000000,
+                      help="number of samples per run [default=%default]")
+    (options, args) = parser.parse_args()
+
+    for name, run in [("rough_symbol_sync_cc", run_rough_symbol_sync), ("sync_frequency_c", run_sync_frequency)]:
+        for fftl in [128, 512, 2048]:
+            run(fftl, options.samples // 10)
+            rss = max_rss_kb()
+            rate = run(fftl, options.samples)
+            print "%-22s fftl = %4i %12.0f correlations/s  %6i kB memory growth" % (name, fftl, rate, max_rss_kb() - rss)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+# Measure descrambler_vfvf throughput in descrambled vectors per second
+# for PBCH and PCFICH vector sizes.
+
+from gnuradio import gr, blocks
+from optparse import OptionParser
+import pmt
+import lte
+import time
+import random
+
+
+def get_tags(n_items, period, n_seqs, key):
+    # one tag at the first item of each sequence
+    tags = []
+    for i in range(0, n_items, period):
+        tag = gr.tag_t()
+        tag.offset = i
+        tag.key = pmt.intern(key)
+        tag.value = pmt.from_long((i // period) % n_seqs)
+        tags.append(tag)
+    return tags
+
+
+def run_descrambler(vlen, seqs, parts, n_vectors):
+    tag_key = "descr"
+    n_items = len(seqs) * parts
+    data = [random.gauss(0, 1) for i in range(vlen * n_items)]
+
+    tb = gr.top_block()
+    src = blocks.vector_source_f(data, True, vlen, get_tags(n_items, parts, len(seqs), tag_key))
+    head = blocks.head(gr.sizeof_float * vlen, n_vectors)
+    descr = lte.descrambler_vfvf(tag_key, "seqs", vlen)
+    descr.set_descr_seqs(seqs)
+    snk = blocks.null_sink(gr.sizeof_float * vlen)
+    tb.connect(src, head, descr, snk)
+
+    start = time.time()
+    tb.run()
+    return n_vectors / (time.time() - start)
+
+
+def main():
+    parser = OptionParser()
+    parser.add_option("-N", "--vectors", type="int", default=1000000,
+                      help="number of vectors to descramble [default=%default]")
+    (options, args) = parser.parse_args()
+
+    cell_id = 124
+    # PBCH: 1920 bit sequence spanning 4 frames with 480 bits each.
+    pbch_seqs = [lte.gold_sequence.nrz(cell_id, 1920)]
+    # PCFICH: 32 bits per subframe, one sequence per subframe.
+    pcfich_seqs = [lte.gold_sequence.nrz((ns // 2 + 1) * (2 * cell_id + 1) * 2 ** 9 + cell_id, 32)
+                   for ns in range(10)]
+
+    for name, vlen, seqs, parts in [("PBCH", 480, pbch_seqs, 4), ("PCFICH", 32, pcfich_seqs, 1)]:
+        rate = run_descrambler(vlen, seqs, parts, options.vectors)
+        print "%-8s vlen = %4i %12.0f vectors/s" % (name, vlen, rate)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
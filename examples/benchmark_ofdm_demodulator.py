@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+# Measure OFDM symbols per second of ofdm_demodulator_cvc and of the
+# remove_cp_cvc, fft_vcc and extract_subcarriers_vcvc chain it replaces.
+
+from gnuradio import gr, blocks, fft
+from gnuradio.fft import window
+from optparse import OptionParser
+import lte
+import pmt
+import time
+import random
+
+
+# FFT lengths and the matching bandwidths
+configs = [(128, 6), (256, 15), (512, 25), (1024, 50), (1536, 75), (2048, 100)]
+
+
+def get_source(fftl):
+    # one frame, repeated with a frame start tag each time
+    frame_len = 20 * (7 * fftl + 6 * (144 * fftl // 2048) + 160 * fftl // 2048)
+    samps = [complex(random.gauss(0, 1), random.gauss(0, 1)) for i in range(frame_len)]
+    tag = gr.tag_t()
+    tag.offset = 0
+    tag.key = pmt.intern('slot')
+    tag.value = pmt.from_long(0)
+    tag.srcid = pmt.intern('benchmark')
+    return blocks.vector_source_c(samps, True, 1, [tag])
+
+
+def run_fused(fftl, N_rb_dl, n_syms):
+    tb = gr.top_block()
+    demod = lte.ofdm_demodulator_cvc(N_rb_dl, fftl, 'symbol')
+    head = blocks.head(gr.sizeof_gr_complex * 12 * N_rb_dl, n_syms)
+    snk = blocks.null_sink(gr.sizeof_gr_complex * 12 * N_rb_dl)
+    tb.connect(get_source(fftl), demod, head, snk)
+
+    start = time.time()
+    tb.run()
+    return n_syms / (time.time() - start)
+
+
+def run_chain(fftl, N_rb_dl, n_syms):
+    tb = gr.top_block()
+    rcp = lte.remove_cp_cvc(fftl, 'symbol')
+    fft_vcc = fft.fft_vcc(fftl, True, window.rectangular(fftl), False, 1)
+    ext = lte.extract_subcarriers_vcvc(N_rb_dl, fftl)
+    head = blocks.head(gr.sizeof_gr_complex * 12 * N_rb_dl, n_syms)
+    snk = blocks.null_sink(gr.sizeof_gr_complex * 12 * N_rb_dl)
+    tb.connect(get_source(fftl), rcp, fft_vcc, ext, head, snk)
+
+    start = time.time()
+    tb.run()
+    return n_syms / (time.time() - start)
+
+
+def main():
+    parser = OptionParser()
+    parser.add_option("-N", "--symbols", type="int", default=200000,
+                      help="number of OFDM symbols per run [default=%default]")
+    (options, args) = parser.parse_args()
+
+    for fftl, N_rb_dl in configs:
+        # scale down for long FFTs to keep the run time similar
+        n_syms = max(options.symbols * 128 // fftl, 1400)
+        fused = run_fused(fftl, N_rb_dl, n_syms)
+        chain = run_chain(fftl, N_rb_dl, n_syms)
+        print "fftl = %4i N_rb_dl = %3i  ofdm_demodulator_cvc %10.0f symbols/s  chain %10.0f symbols/s  %5.2fx" % (fftl, N_rb_dl, fused, chain, fused / chain)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+# Measure SSS symbols per second of sss_calculator_vcm and mimo_sss_calculator.
+# All zero symbols never map to a valid N_id_1, thus the blocks never lock
+# and run the full m0/m1 search on each symbol.
+
+from gnuradio import gr, blocks
+from optparse import OptionParser
+import pmt
+import lte
+import time
+
+
+def run_sss_calculator_vcm(n_symbols):
+    tb = gr.top_block()
+    tag = gr.tag_t()
+    tag.offset = 0
+    tag.key = pmt.intern("N_id_2")
+    tag.value = pmt.from_long(0)
+    src = blocks.vector_source_c([0j] * 72, True, 72, [tag])
+    head = blocks.head(gr.sizeof_gr_complex * 72, n_symbols)
+    sss = lte.sss_calculator_vcm(128, "N_id_2", "offset")
+    tb.connect(src, head, sss)
+
+    start = time.time()
+    tb.run()
+    return n_symbols / (time.time() - start)
+
+
+def run_mimo_sss_calculator(rxant, n_symbols):
+    tb = gr.top_block()
+    src = blocks.vector_source_c([0j] * 72 * rxant, True, 72 * rxant)
+    head = blocks.head(gr.sizeof_gr_complex * 72 * rxant, n_symbols)
+    sss = lte.mimo_sss_calculator(rxant)
+    sss._post(pmt.intern("N_id_2"), pmt.from_long(0))
+    tb.connect(src, head, sss)
+
+    start = time.time()
+    tb.run()
+    return n_symbols / (time.time() - start)
+
+
+def main():
+    parser = OptionParser()
+    parser.add_option("-N", "--symbols", type="int", default=1000000,
+                      help="number of SSS symbols per run [default=%default]")
+    (options, args) = parser.parse_args()
+
+    rate = run_sss_calculator_vcm(options.symbols)
+    print "%-22s          %12.0f SSS symbols/s" % ("sss_calculator_vcm", rate)
+    for rxant in [1, 2, 4]:
+        rate = run_mimo_sss_calculator(rxant, options.symbols)
+        print "%-22s rxant = %i %12.0f SSS symbols/s" % ("mimo_sss_calculator", rxant, rate)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
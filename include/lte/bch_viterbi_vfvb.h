@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_BCH_VITERBI_VFVB_H
+#define INCLUDED_LTE_BCH_VITERBI_VFVB_H
+
+#include <lte/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief BCH Viterbi decoder for the K = 7, rate 1/3 tail-biting code.
+     * \ingroup lte
+     *
+     * Input are 120 soft values (NRZ, positive == 0), output are 40 unpacked bits.
+     * By default each codeword is decoded in one pass over a circularly
+     * extended trellis.
+     * \param wava Use the wrap-around Viterbi algorithm. The circular trellis
+     *             is passed until start and end state of the best survivor match.
+     * \param max_iter Maximum number of trellis passes in WAVA mode.
+     *
+     * The optional second output holds the number of trellis passes (int)
+     * needed for each codeword.
+     */
+    class LTE_API bch_viterbi_vfvb : virtual public gr::sync_block
+    {
+     public:
+      typedef boost::shared_ptr<bch_viterbi_vfvb> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of lte::bch_viterbi_vfvb.
+       *
+       * To avoid accidental use of raw pointers, lte::bch_viterbi_vfvb's
+       * constructor is in a private implementation
+       * class. lte::bch_viterbi_vfvb::make is the public interface for
+       * creating new instances.
+       */
+      static sptr make(bool wava = false, int max_iter = 4,
+                       std::string name = "bch_viterbi_vfvb");
+
+      virtual void set_max_iterations(int max_iter) = 0;
+      virtual int max_iterations() const = 0;
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_BCH_VITERBI_VFVB_H */
+
@@ -0,0 +1,131 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_CELL_SEARCH_H
+#define INCLUDED_LTE_CELL_SEARCH_H
+
+#include <lte/api.h>
+#include <gnuradio/gr_complex.h>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace gr {
+  namespace lte {
+
+    class sss_detector;
+
+    /*!
+     * \brief A cell found by cell_search
+     */
+    struct LTE_API cell_info
+    {
+      int cell_id;
+      // first sample of a radio frame, in [0, 10 ms) from the buffer start
+      long frame_start;
+      // carrier frequency offset in Hz, within +-15 kHz
+      float cfo;
+      // SNR on the PSS subcarriers in dB
+      float snr;
+      // normalized PSS correlation in [0, 1]
+      float pss_corr;
+    };
+
+    /*!
+     * \brief Joint PSS/SSS search for all cells in a buffer of samples
+     * \ingroup lte
+     *
+     * The buffer is correlated with the first and second half of the PSS
+     * of all three N_id_2 at once: each block of samples is transformed
+     * once, its products with the 6 kernels are transformed back in one
+     * batch. Correlation power is folded modulo 5 ms, thus all half frames
+     * in the buffer add up. The strongest peaks of each N_id_2 are PSS
+     * candidates. Each half frame of a candidate is derotated by the CFO
+     * of the PSS halves and its SSS is equalized with the PSS. The SSS of
+     * even and odd half frames are summed. The m-sequence Hadamard detector
+     * scores all 168 N_id_1 and both subframe orders of the two sums,
+     * candidates with a clear best hypothesis are cells. The phase of the
+     * decoded SSS against the PSS refines the CFO.
+     *
+     * Samples are expected at fftl * 15 kHz, e.g. fftl = 128 for the
+     * 72 center subcarriers. search() returns the cells sorted by SNR,
+     * strongest first. A buffer of 20 ms or more is recommended.
+     */
+    class LTE_API cell_search : boost::noncopyable
+    {
+    public:
+      /*!
+       * \param fftl FFT length, sample rate is fftl * 15 kHz
+       * \param max_cells maximum number of PSS candidates per N_id_2
+       * \param threshold minimum normalized PSS correlation, 0 selects 8 / fftl
+       */
+      cell_search(int fftl, int max_cells = 8, float threshold = 0.0f);
+      ~cell_search();
+
+      std::vector<cell_info> search(const gr_complex* in, int len);
+      std::vector<cell_info> search(const std::vector<gr_complex> &in);
+
+    private:
+      // the SSS channel estimate averages 2 * d_H_AVG + 1 subcarriers
+      static const int d_H_AVG = 3;
+      // minimum SSS detector quality, see sss_detector::decode()
+      static const float d_MIN_Q;
+
+      struct candidate
+      {
+        int N_id_2;
+        int pos;
+        float corr;
+      };
+
+      int d_fftl;
+      int d_cpl;
+      int d_halffl;
+      int d_pss_off;
+      int d_max_cells;
+      float d_threshold;
+      // overlap-save block length and step
+      int d_nfft;
+      int d_step;
+
+      float d_pss_energy;
+      gr_complex d_pss_f[3][62];
+      int d_bin[62];
+      sss_detector* d_sss;
+
+      // FFTW buffers and plans, defined in cell_search.cc
+      struct fft_state;
+      fft_state* d_fft;
+
+      // correlation power, conj(first half) * second half and window energy folded modulo 5 ms
+      std::vector<float> d_fold;
+      std::vector<gr_complex> d_fold_cfo;
+      std::vector<double> d_energy;
+
+      void correlate_pss(const gr_complex* in, int len);
+      void find_candidates(std::vector<candidate> &cands);
+      bool decode_cell(const gr_complex* in, int len, const candidate &cand, cell_info &cell);
+      void symbol_bins(gr_complex* out, const gr_complex* in, long pos, float cfo);
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_CELL_SEARCH_H */
+
@@ -38,6 +38,9 @@ namespace gr {
      *                      second vector contains indices of pilot carriers
      * \param pilot_symbols A vector of vectors with pilot symbol values
      *                      same as pilot_carriers but complex values.
+     * \param complex_interp Interpolate estimates as complex values instead of
+     *                      magnitude and phase. Saves all atan2 and sin/cos
+     *                      calculations and runs entirely on VOLK kernels.
      *
      */
     class LTE_API channel_estimator_vcvc : virtual public gr::sync_block
@@ -58,7 +61,8 @@ namespace gr {
            std::string msg_buf_name,
            const std::vector<std::vector<int> > &pilot_carriers,
            const std::vector<std::vector<gr_complex> > &pilot_symbols,
-           std::string name = "channel_estimator_vcvc");
+           std::string name = "channel_estimator_vcvc",
+           bool complex_interp = false);
 
       virtual void
       set_pilot_map(
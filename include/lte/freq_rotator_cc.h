@@ -0,0 +1,64 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_LTE_FREQ_ROTATOR_CC_H
+#define INCLUDED_LTE_FREQ_ROTATOR_CC_H
+
+#include <lte/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Frequency offset correction of all RX antennas by one NCO
+     * \ingroup lte
+     *
+     * Each stream is multiplied by exp(-j*2*pi*freq*n/samp_rate) with a
+     * continuous phase. freq (Hz) is updated by a "freq" stream tag at the
+     * tagged item, or by a message on the freq port: a double applies from
+     * the next work call on, a pair (offset . freq) at item offset.
+     * mimo_pss_freq_sync and sync_frequency_c publish their estimates there.
+     */
+    class LTE_API freq_rotator_cc : virtual public gr::sync_block
+    {
+     public:
+      typedef boost::shared_ptr<freq_rotator_cc> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of lte::freq_rotator_cc.
+       *
+       * To avoid accidental use of raw pointers, lte::freq_rotator_cc's
+       * constructor is in a private implementation
+       * class. lte::freq_rotator_cc::make is the public interface for
+       * creating new instances.
+       */
+      static sptr make(int rxant, double samp_rate, std::string name = "freq_rotator_cc");
+
+      virtual void set_freq(double freq) = 0;
+      virtual double freq() = 0;
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_FREQ_ROTATOR_CC_H */
+
@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_GOLD_SEQUENCE_H
+#define INCLUDED_LTE_GOLD_SEQUENCE_H
+
+#include <lte/api.h>
+#include <stdint.h>
+#include <vector>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Pseudo-random sequence generator as specified in 36.211 7.2
+     * \ingroup lte
+     *
+     * Length-31 Gold sequence c(n) = x1(n + Nc) + x2(n + Nc) mod 2 with
+     * Nc = 1600 and x2 initialized with c_init.
+     * Both LFSRs are kept as 32 bit words and advanced by 32 bits per step.
+     * The first bit of a word is stored in its LSB.
+     * NRZ output maps 0 to +1.0 and 1 to -1.0.
+     */
+    class LTE_API gold_sequence
+    {
+    public:
+      gold_sequence(uint32_t c_init = 0);
+
+      // Restart the sequence for c_init.
+      void init(uint32_t c_init);
+      // Next 32 bits of c(n)
+      uint32_t next_word();
+
+      void generate_bits(char* out, int len);
+      void generate_nrz(float* out, int len);
+
+      // The first len elements of the sequence for c_init.
+      static std::vector<int> bits(uint32_t c_init, int len);
+      static std::vector<float> nrz(uint32_t c_init, int len);
+      static void nrz(float* out, int len, uint32_t c_init);
+
+    private:
+      uint32_t d_x1;
+      uint32_t d_x2;
+
+      void advance();
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_GOLD_SEQUENCE_H */
@@ -0,0 +1,131 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_MIB_DECODER_H
+#define INCLUDED_LTE_MIB_DECODER_H
+
+#include <lte/api.h>
+#include <lte/gold_sequence.h>
+#include <lte/tail_biting_viterbi.h>
+#include <gnuradio/gr_complex.h>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Content of a decoded MIB, see mib_unpack_vbm
+     */
+    struct LTE_API mib_info
+    {
+      // 1, 2 or 4 as signalled by the CRC mask
+      int N_ant;
+      int N_rb_dl;
+      // 0 normal, 1 extended
+      int phich_duration;
+      // Ng
+      float phich_resources;
+      // SFN of the decoded frame
+      int sfn;
+    };
+
+    /*!
+     * \brief PBCH and BCH decoding of one radio frame
+     * \ingroup lte
+     *
+     * The standalone counterpart of pbch_decoder_vcvf and the BCH decoder
+     * hier block for a cell found by cell_search. The OFDM symbols of
+     * subframe 0 slot 1 are derotated by the CFO and transformed, the
+     * channel of antenna ports 0 and 1 is estimated from their reference
+     * signals in symbols 0 and 4 of the slot. N_ant = 1 and N_ant = 2 are
+     * equalized, each with all 4 frame positions within 40 ms. The 4
+     * codewords of a frame are soft combined, deinterleaved and Viterbi
+     * decoded. The first hypothesis with a valid CRC is the MIB.
+     *
+     * Samples are expected at fftl * 15 kHz. decode() reads
+     * samples_needed() samples from the first sample of the frame.
+     */
+    class LTE_API mib_decoder : boost::noncopyable
+    {
+    public:
+      mib_decoder(int fftl);
+      ~mib_decoder();
+
+      bool decode(mib_info &mib, const gr_complex* frame, int cell_id, float cfo);
+      bool decode(mib_info &mib, const std::vector<gr_complex> &frame, int cell_id, float cfo);
+
+      int samples_needed() const { return d_sym_pos[d_N_SYMS - 1] + d_fftl; }
+
+    private:
+      static const int d_N_SC = 72;
+      static const int d_N_PBCH = 240;
+      static const int d_N_PARTS = 4;
+      static const int d_CW_LEN = 120;
+      static const int d_N_BITS = 40;
+      static const int d_MIB_LEN = 24;
+      // slot 1 symbols 0 to 4, the PBCH is in the first 4
+      static const int d_N_SYMS = 5;
+
+      int d_fftl;
+      int d_sym_pos[d_N_SYMS];
+      int d_cell_id;
+
+      // FFTW buffers and plan of one OFDM symbol, defined in mib_decoder.cc
+      struct fft_state;
+      fft_state* d_fft;
+
+      gold_sequence d_gold;
+      tail_biting_viterbi d_viterbi;
+      std::vector<float> d_pn_seq;
+      std::vector<char> d_rs_bits;
+      // reference signals and first subcarrier of ports 0, 1 in symbols 0, 4
+      gr_complex d_rs[2][2][12];
+      int d_rs_off[2][2];
+      // PBCH REs in d_grid
+      std::vector<int> d_re_pos;
+      std::vector<int> d_interleaved_pos;
+
+      // center subcarriers of each symbol
+      std::vector<gr_complex> d_grid;
+      // channel of ports 0 and 1 at all PBCH REs
+      std::vector<gr_complex> d_ce0;
+      std::vector<gr_complex> d_ce1;
+      std::vector<gr_complex> d_rx;
+      std::vector<float> d_soft;
+      std::vector<float> d_cw;
+      std::vector<float> d_code;
+      std::vector<char> d_bits;
+
+      void set_cell_id(int cell_id);
+      void estimate_channel(std::vector<gr_complex> &ce, int port);
+      void interpolate_symbol(gr_complex* h, int port, int rs_sym);
+      void decode_1_ant(float* soft);
+      void decode_2_ant(float* soft);
+      bool decode_bch(mib_info &mib, const float* soft);
+      int check_crc();
+      void unpack_mib(mib_info &mib);
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_MIB_DECODER_H */
+
@@ -28,9 +28,15 @@ namespace gr {
   namespace lte {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Forwards samples to the coarse PSS sync until it reports a result
      * \ingroup lte
      *
+     * A PMT_T on the control port stops forwarding, PMT_F resumes it.
+     * After the first lock, forwarding means re-acquisition: only the first
+     * of every reacq_period half frames is passed on, which cuts the load of
+     * the decimating filter and the coarse sync by that factor. The PSS is
+     * repeated every half frame, thus output stays aligned to the input
+     * modulo the half frame length of fftl.
      */
     class LTE_API mimo_pss_coarse_control : virtual public gr::block
     {
@@ -45,7 +51,7 @@ namespace gr {
        * class. lte::mimo_pss_coarse_control::make is the public interface for
        * creating new instances.
        */
-      static sptr make(int rxant);
+      static sptr make(int rxant, int fftl = 2048, int reacq_period = 8);
     };
 
   } // namespace lte
@@ -29,9 +29,16 @@ namespace gr {
   namespace lte {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Coarse PSS timing and N_id_2 search over syncl blocks of 4800 samples
      * \ingroup lte
      *
+     * With fft_corr the differential correlations of all timing hypotheses
+     * are calculated by overlap-save FFT correlation instead of one dot
+     * product per hypothesis.
+     * With nthreads > 1 the RX antennas are correlated in parallel.
+     * A PMT_F on the lock port (loss of lock in fine sync) starts a new
+     * search once the previous one is done. PMT_F is published on the
+     * control port to let mimo_pss_coarse_control forward samples again.
      */
     class LTE_API mimo_pss_coarse_sync : virtual public gr::sync_block
     {
@@ -46,7 +53,10 @@ namespace gr {
        * class. lte::mimo_pss_coarse_sync::make is the public interface for
        * creating new instances.
        */
-      static sptr make(int syncl, int rxant);
+      static sptr make(int syncl, int rxant, bool fft_corr = true, int nthreads = 1);
+
+      //! Time in ms from the first work call of the last search to its N_id_2 decision, -1 while searching
+      virtual double time_to_lock() = 0;
     };
 
   } // namespace lte
@@ -29,9 +29,23 @@ namespace gr {
   namespace lte {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Fine PSS timing around the coarse position and PSS tracking
      * \ingroup lte
      *
+     * With nthreads > 1 the RX antennas are correlated in parallel.
+     *
+     * While tracking, the correlation at the tracked position is normalized
+     * by the Cauchy-Schwarz bound of each part product (1 for a clean PSS).
+     * Lock is declared lost and PMT_F published on the lock port if this
+     * quality stays below a quarter of its running average, or near the
+     * noise level, for several half frames. half_frame is published on lock
+     * and on changes of the half frame start only.
+     *
+     * The early, prompt and late correlations give a sub-sample peak
+     * position by parabolic interpolation. On every tracked PSS the half
+     * frame start including this fraction (a double, modulo the half frame
+     * length) is published on frac_timing. Its drift over time is the
+     * sampling clock offset, for a fractional resampler to correct.
      */
     class LTE_API mimo_pss_fine_sync : virtual public gr::sync_block
     {
@@ -46,7 +60,10 @@ namespace gr {
        * class. lte::mimo_pss_fine_sync::make is the public interface for
        * creating new instances.
        */
-      static sptr make(int fftl, int rxant, int grpdelay);
+      static sptr make(int fftl, int rxant, int grpdelay, int nthreads = 1);
+
+      //! Normalized PSS correlation of the last tracked half frame
+      virtual float lock_quality() = 0;
     };
 
   } // namespace lte
@@ -30,9 +30,12 @@ namespace gr {
   namespace lte {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Frequency offset estimation from the two halves of the PSS
      * \ingroup lte
      *
+     * The estimated offset (Hz) is published on the freq port, for
+     * freq_rotator_cc, and set as negative frequency of sig unless sig is
+     * empty.
      */
     class LTE_API mimo_pss_freq_sync : virtual public gr::sync_block
     {
@@ -28,9 +28,19 @@ namespace gr {
   namespace lte {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Remove the CP from the streams of all RX antennas
      * \ingroup lte
      *
+     * With N_rb_dl = 0 each RX antenna has an output stream of time domain
+     * OFDM symbols of fftl samples, to be transformed by fft_vxx.
+     *
+     * With N_rb_dl > 0 the block demodulates: each run of 7 consecutive
+     * symbols of all antennas is transformed by one batched FFT, the runs
+     * are not aligned to slots. The single output has one vector of
+     * 12 * N_rb_dl * rxant subcarriers per OFDM symbol, the
+     * occupied subcarriers of each antenna ordered like the output of
+     * extract_subcarriers_vcvc and concatenated. That is the input of
+     * channel_estimator_vcvc, pbch_demux_vcvc and mimo_sss_tagger.
      */
     class LTE_API mimo_remove_cp : virtual public gr::block
     {
@@ -45,7 +55,7 @@ namespace gr {
        * class. lte::mimo_remove_cp::make is the public interface for
        * creating new instances.
        */
-      static sptr make(int fflt, int rxant, std::string key);
+      static sptr make(int fftl, int rxant, std::string key, int N_rb_dl = 0);
     };
 
   } // namespace lte
@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+
+#ifndef INCLUDED_LTE_OFDM_DEMODULATOR_CVC_H
+#define INCLUDED_LTE_OFDM_DEMODULATOR_CVC_H
+
+#include <lte/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Remove the CP, transform and extract the occupied subcarriers in one step
+     * \ingroup lte
+     *
+     * Replaces remove_cp_cvc, fft_vxx and extract_subcarriers_vcvc. FFTW
+     * runs directly on the input buffer behind each CP, the 6 symbols with
+     * a short CP in a slot in one batch. Only the 12 * N_rb_dl occupied
+     * subcarriers are copied to the output, ordered like the output of
+     * extract_subcarriers_vcvc. Frame sync and output tags are the same as
+     * in remove_cp_cvc: the input is dropped up to a "slot" tag with value
+     * 0 (frame start) as set by sss_tagger_cc, the first symbol of each slot
+     * is tagged on key with its symbol number.
+     */
+    class LTE_API ofdm_demodulator_cvc : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<ofdm_demodulator_cvc> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of lte::ofdm_demodulator_cvc.
+       *
+       * To avoid accidental use of raw pointers, lte::ofdm_demodulator_cvc's
+       * constructor is in a private implementation
+       * class. lte::ofdm_demodulator_cvc::make is the public interface for
+       * creating new instances.
+       */
+      static sptr make(int N_rb_dl, int fftl, std::string key, std::string name = "ofdm_demodulator_cvc");
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_OFDM_DEMODULATOR_CVC_H */
+
@@ -0,0 +1,66 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_LTE_PBCH_DECODER_VCVF_H
+#define INCLUDED_LTE_PBCH_DECODER_VCVF_H
+
+#include <lte/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Fused PBCH chain from resource grid to descrambled soft bits
+     * \ingroup lte
+     *
+     * Does the work of pbch_demux_vcvc, pre_decoder_vcvc, layer_demapper_vcvc,
+     * qpsk_soft_demod_vcvf and the PBCH descrambler hier block in one pass.
+     * Inputs are the resource grid and the channel estimates of antenna
+     * ports 0 and 1. For each PBCH the tx diversity hypotheses N_ant = 1
+     * and N_ant = 2 are decoded, each one yields 20 vectors of 120 soft
+     * bits, ordered like the output of lte_pbch_decoder_mimo_2tx. Symbol
+     * numbers are taken from the key tags of the resource grid input, as set
+     * by remove_cp_cvc, other tags are ignored.
+     */
+    class LTE_API pbch_decoder_vcvf : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<pbch_decoder_vcvf> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of lte::pbch_decoder_vcvf.
+       *
+       * To avoid accidental use of raw pointers, lte::pbch_decoder_vcvf's
+       * constructor is in a private implementation
+       * class. lte::pbch_decoder_vcvf::make is the public interface for
+       * creating new instances.
+       */
+      static sptr make(int N_rb_dl, int rxant, std::string key, std::string name = "pbch_decoder_vcvf");
+
+      virtual void set_cell_id(int id) = 0;
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_PBCH_DECODER_VCVF_H */
+
@@ -0,0 +1,61 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_PCFICH_SCRAMBLE_SEQUENCER_M_H
+#define INCLUDED_LTE_PCFICH_SCRAMBLE_SEQUENCER_M_H
+
+#include <lte/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Generate PCFICH descrambling sequences for a cell ID
+     * \ingroup lte
+     *
+     * Takes in a message with the cell ID and publishes the NRZ coded
+     * scrambling sequences of all 10 subframes (36.211 6.7.1) as one table.
+     * The message is a pair (10 . f32vector) with 32 values per subframe
+     * as accepted by descrambler_vfvf. Tables are cached per cell ID.
+     */
+    class LTE_API pcfich_scramble_sequencer_m : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<pcfich_scramble_sequencer_m> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of lte::pcfich_scramble_sequencer_m.
+       *
+       * To avoid accidental use of raw pointers, lte::pcfich_scramble_sequencer_m's
+       * constructor is in a private implementation
+       * class. lte::pcfich_scramble_sequencer_m::make is the public interface for
+       * creating new instances.
+       */
+      static sptr make(std::string name = "pcfich_scramble_sequencer_m");
+
+      // descrambling table message for cell_id. Calculated on first use.
+      virtual pmt::pmt_t descr_table(int cell_id) = 0;
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_PCFICH_SCRAMBLE_SEQUENCER_M_H */
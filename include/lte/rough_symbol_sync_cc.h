@@ -32,6 +32,11 @@ namespace gr {
      * \brief CP based rough sync to OFDM symbols
      * \ingroup lte
      *
+     * ML timing and fractional frequency offset after van de Beek. CP
+     * correlation and energy are moving sums updated once per sample and
+     * averaged over slots. Once the first slot of input is complete, each
+     * work call tags the CP start of the best symbol modulo the slot length
+     * ("symbol") and the frequency offset in subcarrier spacings ("frac_cfo").
      */
     class LTE_API rough_symbol_sync_cc : virtual public gr::sync_block
     {
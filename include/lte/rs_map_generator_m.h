@@ -0,0 +1,67 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_RS_MAP_GENERATOR_M_H
+#define INCLUDED_LTE_RS_MAP_GENERATOR_M_H
+
+#include <lte/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Generate cell specific reference signal map for one antenna port
+     * \ingroup lte
+     *
+     * Takes in a message with the cell ID. Calculates pilot positions and
+     * values of all OFDM symbols in a frame (36.211 6.10.1) and passes them
+     * on as a message of 3 uniform vectors (offsets, positions, values).
+     * Pilots of OFDM symbol i are stored in [offsets[i], offsets[i + 1]).
+     * Messages are cached per cell ID. Thus switching back to a known cell
+     * does not recalculate anything.
+     */
+    class LTE_API rs_map_generator_m : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<rs_map_generator_m> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of lte::rs_map_generator_m.
+       *
+       * To avoid accidental use of raw pointers, lte::rs_map_generator_m's
+       * constructor is in a private implementation
+       * class. lte::rs_map_generator_m::make is the public interface for
+       * creating new instances.
+       */
+      static sptr make(std::string msg_buf_name_in,
+                       std::string msg_buf_name_out, int N_rb_dl, int ant_port,
+                       std::string name = "rs_map_generator_m");
+
+      // pilot map message for cell_id. Calculated on first use.
+      virtual pmt::pmt_t pilot_map(int cell_id) = 0;
+      // Calculate pilot maps of all 504 cell IDs in advance.
+      virtual void precompute_pilot_maps() = 0;
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_RS_MAP_GENERATOR_M_H */
@@ -34,6 +34,8 @@ namespace gr {
      * \ingroup lte
 
      * This block calculates FFO by correlating CPs and sets the frequency of a signal source block.
+     * The offset (Hz) is published on the freq port as well, for freq_rotator_cc.
+     * Pass an empty sig to use the message only.
      *
      */
     class LTE_API sync_frequency_c : virtual public gr::sync_block
@@ -0,0 +1,100 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_TAIL_BITING_VITERBI_H
+#define INCLUDED_LTE_TAIL_BITING_VITERBI_H
+
+#include <lte/api.h>
+#include <stdint.h>
+#include <boost/noncopyable.hpp>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Helper class for decoding the LTE tail-biting convolutional code
+     * \ingroup lte
+     *
+     * K = 7, rate 1/3 code with generator polynomials 133, 171, 165 (octal)
+     * as specified in 36.212 5.1.3.1.
+     * Input are 3 * len soft values in encoder output order (d0, d1, d2 per bit)
+     * with NRZ mapping, i.e. positive values indicate a 0.
+     * Output are len unpacked bits.
+     *
+     * decode() extends the trellis circularly by wrap_len steps at its beginning
+     * and at its end. Survivors are traced back from the best state.
+     * decode_wava() runs the wrap-around Viterbi algorithm instead. It passes
+     * the circular trellis repeatedly, each pass starting with the final path
+     * metrics of the previous one, until the best survivor starts and ends
+     * in the same state or max_iter passes are done. In the latter case
+     * the best tail-biting survivor of all passes is returned if there is one.
+     * Add-compare-select runs on 4 states in parallel if SSE2 is available.
+     * The decoder owns its volk buffers and is therefore not copyable.
+     */
+    class LTE_API tail_biting_viterbi : boost::noncopyable
+    {
+    public:
+      tail_biting_viterbi(int len);
+      ~tail_biting_viterbi();
+
+      void decode(char* out, const float* in);
+      int decode_wava(char* out, const float* in, int max_iter);
+
+      int len() const { return d_len; }
+      int wrap_len() const { return d_wrap_len; }
+
+      static const int K = 7;
+      static const int N_STATES = 64;
+      static const int RATE = 3;
+
+    private:
+      int d_len;
+      int d_wrap_len;
+
+      // path metrics, double buffered
+      float* d_metric;
+      float* d_metric_next;
+      // branch metric for each state assuming the oldest register bit is 0
+      float* d_branch;
+      // NRZ encoder output for each state, one row per generator polynomial
+      float* d_sign;
+      // survivor decisions. bit s of step t is set if state s was reached
+      // from the predecessor with the oldest register bit set.
+      uint64_t* d_decisions;
+
+      // wrap-around Viterbi: metrics at the start of the current pass
+      // and the best tail-biting survivor seen so far
+      float* d_start_metric;
+      char* d_tb_bits;
+      char* d_best_tb_bits;
+
+      void init_sign_table();
+      void reset_metrics();
+      void normalize_metrics(float ref);
+      void acs(uint64_t* decisions, const float* in, int first, int steps);
+      int best_state() const;
+      int traceback(char* out, const uint64_t* decisions, int state,
+                    int steps, int skip);
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_TAIL_BITING_VITERBI_H */
@@ -0,0 +1,86 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_ALIGNED_BUFFER_H
+#define INCLUDED_LTE_ALIGNED_BUFFER_H
+
+#include <volk/volk.h>
+#include <boost/noncopyable.hpp>
+#include <algorithm>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Owned VOLK aligned memory for blocks that need aligned work buffers.
+     *
+     * Memory is only reallocated if a resize exceeds the current capacity.
+     * Otherwise the existing memory is reused. Contents are not preserved
+     * on reallocation.
+     */
+    template<typename T>
+    class aligned_buffer : boost::noncopyable
+    {
+    public:
+      aligned_buffer() : d_ptr(NULL), d_size(0), d_capacity(0) {}
+      explicit aligned_buffer(size_t size) : d_ptr(NULL), d_size(0), d_capacity(0)
+      {
+        resize(size);
+      }
+      ~aligned_buffer() { volk_free(d_ptr); }
+
+      void resize(size_t size)
+      {
+        if(size > d_capacity){
+          volk_free(d_ptr);
+          d_ptr = (T*) volk_malloc(sizeof(T) * size, volk_get_alignment());
+          d_capacity = size;
+        }
+        d_size = size;
+      }
+
+      void zero() { std::fill(d_ptr, d_ptr + d_size, T()); }
+
+      T* data() { return d_ptr; }
+      const T* data() const { return d_ptr; }
+      size_t size() const { return d_size; }
+      T& operator[](size_t i) { return d_ptr[i]; }
+      const T& operator[](size_t i) const { return d_ptr[i]; }
+
+      // Number of elements to keep consecutive vectors of len elements aligned.
+      static size_t aligned_len(size_t len)
+      {
+        size_t alig = volk_get_alignment() / sizeof(T);
+        if(alig < 1){
+          alig = 1;
+        }
+        return ((len + alig - 1) / alig) * alig;
+      }
+
+    private:
+      T* d_ptr;
+      size_t d_size;
+      size_t d_capacity;
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_ALIGNED_BUFFER_H */
@@ -0,0 +1,125 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "antenna_pool.h"
+#include <boost/bind.hpp>
+
+namespace gr {
+  namespace lte {
+
+    antenna_pool::antenna_pool(int nthreads) :
+        d_nthreads(nthreads < 1 ? 1 : nthreads),
+        d_job(NULL), d_ntasks(0), d_next_task(0), d_pending(0),
+        d_generation(0), d_stop(false)
+    {
+      for(int id = 1; id < d_nthreads; id++){
+        d_threads.create_thread(boost::bind(&antenna_pool::worker, this, id));
+      }
+    }
+
+    antenna_pool::~antenna_pool()
+    {
+      {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_stop = true;
+      }
+      d_start_cond.notify_all();
+      d_threads.join_all();
+    }
+
+    void
+    antenna_pool::run(const job_t &job, int ntasks)
+    {
+      if(d_nthreads == 1 || ntasks < 2){
+        for(int t = 0; t < ntasks; t++){
+          job(t, 0);
+        }
+        return;
+      }
+
+      {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_job = &job;
+        d_ntasks = ntasks;
+        d_next_task = 0;
+        d_pending = ntasks;
+        d_generation++;
+      }
+      d_start_cond.notify_all();
+
+      work_on_tasks(0);
+
+      gr::thread::scoped_lock lock(d_mutex);
+      while(d_pending > 0){
+        d_done_cond.wait(lock);
+      }
+      d_job = NULL;
+    }
+
+    void
+    antenna_pool::worker(int id)
+    {
+      unsigned int seen = 0;
+      while(true){
+        {
+          gr::thread::scoped_lock lock(d_mutex);
+          while(!d_stop && d_generation == seen){
+            d_start_cond.wait(lock);
+          }
+          if(d_stop){
+            return;
+          }
+          seen = d_generation;
+        }
+        work_on_tasks(id);
+      }
+    }
+
+    void
+    antenna_pool::work_on_tasks(int id)
+    {
+      while(true){
+        const job_t* job;
+        int task;
+        {
+          gr::thread::scoped_lock lock(d_mutex);
+          if(d_next_task >= d_ntasks){
+            return;
+          }
+          job = d_job;
+          task = d_next_task++;
+        }
+
+        (*job)(task, id);
+
+        gr::thread::scoped_lock lock(d_mutex);
+        if(--d_pending == 0){
+          d_done_cond.notify_all();
+        }
+      }
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
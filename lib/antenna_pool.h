@@ -0,0 +1,74 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_ANTENNA_POOL_H
+#define INCLUDED_LTE_ANTENNA_POOL_H
+
+#include <gnuradio/thread/thread.h>
+#include <boost/thread/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Worker threads to process the streams of several RX antennas in parallel.
+     *
+     * run() calls job(task, worker) for all tasks and returns when all calls
+     * are done. The calling thread works on tasks as well, thus nthreads
+     * includes it. worker is in [0, nthreads) and identifies scratch memory
+     * a job may use exclusively. With nthreads = 1 no threads are started
+     * and tasks are processed in order.
+     */
+    class antenna_pool : boost::noncopyable
+    {
+    public:
+      typedef boost::function<void (int, int)> job_t;
+
+      antenna_pool(int nthreads);
+      ~antenna_pool();
+
+      void run(const job_t &job, int ntasks);
+      int nthreads() const { return d_nthreads; }
+
+    private:
+      int d_nthreads;
+      boost::thread_group d_threads;
+      gr::thread::mutex d_mutex;
+      gr::thread::condition_variable d_start_cond;
+      gr::thread::condition_variable d_done_cond;
+
+      const job_t* d_job;
+      int d_ntasks;
+      int d_next_task;
+      int d_pending;
+      unsigned int d_generation;
+      bool d_stop;
+
+      void worker(int id);
+      void work_on_tasks(int id);
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_ANTENNA_POOL_H */
+
@@ -0,0 +1,98 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "bch_viterbi_vfvb_impl.h"
+#include <stdexcept>
+
+namespace gr {
+  namespace lte {
+
+    bch_viterbi_vfvb::sptr
+    bch_viterbi_vfvb::make(bool wava, int max_iter, std::string name)
+    {
+      return gnuradio::get_initial_sptr
+        (new bch_viterbi_vfvb_impl(wava, max_iter, name));
+    }
+
+    /*
+     * The private constructor
+     */
+    bch_viterbi_vfvb_impl::bch_viterbi_vfvb_impl(bool wava, int max_iter, std::string& name)
+      : gr::sync_block(name,
+              gr::io_signature::make(1, 1, sizeof(float) * 3 * d_N_BITS),
+              gr::io_signature::make2(1, 2, sizeof(char) * d_N_BITS, sizeof(int))),
+              d_viterbi(d_N_BITS),
+              d_wava(wava)
+    {
+      set_max_iterations(max_iter);
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    bch_viterbi_vfvb_impl::~bch_viterbi_vfvb_impl()
+    {
+    }
+
+    int
+    bch_viterbi_vfvb_impl::work(int noutput_items,
+              gr_vector_const_void_star &input_items,
+              gr_vector_void_star &output_items)
+    {
+      const float *in = (const float *) input_items[0];
+      char *out = (char *) output_items[0];
+      int *iter_out = output_items.size() > 1 ? (int *) output_items[1] : NULL;
+
+      for(int i = 0; i < noutput_items; i++){
+        int iter = 1;
+        if(d_wava){
+          iter = d_viterbi.decode_wava(out, in, d_max_iter);
+        }
+        else{
+          d_viterbi.decode(out, in);
+        }
+        if(iter_out){
+          iter_out[i] = iter;
+        }
+        in += 3 * d_N_BITS;
+        out += d_N_BITS;
+      }
+
+      // Tell runtime system how many output items we produced.
+      return noutput_items;
+    }
+
+    void
+    bch_viterbi_vfvb_impl::set_max_iterations(int max_iter)
+    {
+      if(max_iter < 1){
+        throw std::invalid_argument("bch_viterbi_vfvb: max_iter must be at least 1");
+      }
+      d_max_iter = max_iter;
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
@@ -0,0 +1,55 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_BCH_VITERBI_VFVB_IMPL_H
+#define INCLUDED_LTE_BCH_VITERBI_VFVB_IMPL_H
+
+#include <lte/bch_viterbi_vfvb.h>
+#include <lte/tail_biting_viterbi.h>
+
+namespace gr {
+  namespace lte {
+
+    class bch_viterbi_vfvb_impl : public bch_viterbi_vfvb
+    {
+     private:
+      static const int d_N_BITS = 40;
+      tail_biting_viterbi d_viterbi;
+      bool d_wava;
+      int d_max_iter;
+
+     public:
+      bch_viterbi_vfvb_impl(bool wava, int max_iter, std::string& name);
+      ~bch_viterbi_vfvb_impl();
+
+      // Where all the action really happens
+      int work(int noutput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items);
+
+      void set_max_iterations(int max_iter);
+      int max_iterations() const { return d_max_iter; }
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_BCH_VITERBI_VFVB_IMPL_H */
+
@@ -0,0 +1,377 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <lte/cell_search.h>
+#include <lte/pss.h>
+#include "sss_detector.h"
+#include <volk/volk.h>
+#include <fftw3.h>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+
+namespace gr {
+  namespace lte {
+
+    const float cell_search::d_MIN_Q = 5.0f;
+
+    struct cell_search::fft_state : boost::noncopyable
+    {
+      fft_state(int fftl, int nfft);
+      ~fft_state();
+
+      // overlap-save PSS correlation, 6 kernels of nfft bins
+      gr_complex* kernels;
+      gr_complex* fft_in;
+      gr_complex* fft_out;
+      gr_complex* prod;
+      gr_complex* corr;
+      fftwf_plan plan_f;
+      fftwf_plan plan_r;
+
+      // one OFDM symbol for the PSS and SSS subcarriers
+      gr_complex* sym_in;
+      gr_complex* sym_out;
+      fftwf_plan plan_sym;
+    };
+
+    cell_search::fft_state::fft_state(int fftl, int nfft)
+    {
+      kernels = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * 6 * nfft);
+      fft_in = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * nfft);
+      fft_out = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * nfft);
+      prod = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * 6 * nfft);
+      corr = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * 6 * nfft);
+      sym_in = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * fftl);
+      sym_out = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * fftl);
+
+      plan_f = fftwf_plan_dft_1d(nfft, reinterpret_cast<fftwf_complex*>(fft_in),
+                                 reinterpret_cast<fftwf_complex*>(fft_out),
+                                 FFTW_FORWARD, FFTW_ESTIMATE);
+      // all kernels are transformed back at once
+      plan_r = fftwf_plan_many_dft(1, &nfft, 6,
+                                   reinterpret_cast<fftwf_complex*>(prod), NULL, 1, nfft,
+                                   reinterpret_cast<fftwf_complex*>(corr), NULL, 1, nfft,
+                                   FFTW_BACKWARD, FFTW_ESTIMATE);
+      plan_sym = fftwf_plan_dft_1d(fftl, reinterpret_cast<fftwf_complex*>(sym_in),
+                                   reinterpret_cast<fftwf_complex*>(sym_out),
+                                   FFTW_FORWARD, FFTW_ESTIMATE);
+    }
+
+    cell_search::fft_state::~fft_state()
+    {
+      fftwf_destroy_plan(plan_f);
+      fftwf_destroy_plan(plan_r);
+      fftwf_destroy_plan(plan_sym);
+      fftwf_free(kernels);
+      fftwf_free(fft_in);
+      fftwf_free(fft_out);
+      fftwf_free(prod);
+      fftwf_free(corr);
+      fftwf_free(sym_in);
+      fftwf_free(sym_out);
+    }
+
+    static bool
+    stronger(const cell_info &a, const cell_info &b)
+    {
+      return a.snr > b.snr;
+    }
+
+    cell_search::cell_search(int fftl, int max_cells, float threshold) :
+        d_fftl(fftl),
+        d_cpl(144 * fftl / 2048),
+        d_halffl(75 * fftl),
+        d_pss_off(6 * fftl + (6 * 144 + 160) * fftl / 2048),
+        d_max_cells(max_cells),
+        d_threshold(threshold > 0.0f ? threshold : 8.0f / fftl),
+        d_nfft(4 * fftl),
+        d_step(3 * fftl),
+        d_sss(new sss_detector),
+        d_fold(3 * 75 * fftl),
+        d_fold_cfo(3 * 75 * fftl),
+        d_energy(75 * fftl)
+    {
+      if(fftl < 128 || fftl % 128 != 0){
+        delete d_sss;
+        throw std::invalid_argument("cell_search: fftl must be a multiple of 128");
+      }
+
+      // PSS subcarriers -31 ... -1 and 1 ... 31
+      for(int c = 0; c < 62; c++){
+        d_bin[c] = c < 31 ? c - 31 + d_fftl : c - 30;
+      }
+
+      d_fft = new fft_state(d_fftl, d_nfft);
+
+      // Kernel 2 * N_id_2 + h is half h of the PSS, transformed and
+      // conjugated for correlation. 1 / nfft scales the inverse transform.
+      const int half = d_fftl / 2;
+      std::vector<gr_complex> pss_t(d_fftl);
+      for(int id = 0; id < 3; id++){
+        pss::gen_pss_t(&pss_t[0], id, d_fftl);
+        for(int h = 0; h < 2; h++){
+          memset(d_fft->fft_in, 0, sizeof(gr_complex) * d_nfft);
+          memcpy(d_fft->fft_in, &pss_t[h * half], sizeof(gr_complex) * half);
+          fftwf_execute(d_fft->plan_f);
+          gr_complex* kernel = d_fft->kernels + (2 * id + h) * d_nfft;
+          for(int i = 0; i < d_nfft; i++){
+            kernel[i] = std::conj(d_fft->fft_out[i]) / float(d_nfft);
+          }
+        }
+        pss::zc(d_pss_f[id], id);
+      }
+
+      d_pss_energy = 0.0f;
+      for(int i = 0; i < d_fftl; i++){
+        d_pss_energy += std::norm(pss_t[i]);
+      }
+    }
+
+    cell_search::~cell_search()
+    {
+      delete d_fft;
+      delete d_sss;
+    }
+
+    std::vector<cell_info>
+    cell_search::search(const std::vector<gr_complex> &in)
+    {
+      if(in.empty()){
+        return std::vector<cell_info>();
+      }
+      return search(&in[0], in.size());
+    }
+
+    std::vector<cell_info>
+    cell_search::search(const gr_complex* in, int len)
+    {
+      std::vector<cell_info> cells;
+      if(len < d_fftl){
+        return cells;
+      }
+
+      correlate_pss(in, len);
+
+      std::vector<candidate> cands;
+      find_candidates(cands);
+
+      for(unsigned int c = 0; c < cands.size(); c++){
+        cell_info cell;
+        if(!decode_cell(in, len, cands[c], cell)){
+          continue;
+        }
+        // echoes and sidelobes of a cell decode to its cell ID again
+        bool known = false;
+        for(unsigned int i = 0; i < cells.size(); i++){
+          if(cells[i].cell_id == cell.cell_id){
+            if(cell.snr > cells[i].snr){
+              cells[i] = cell;
+            }
+            known = true;
+            break;
+          }
+        }
+        if(!known){
+          cells.push_back(cell);
+        }
+      }
+
+      std::sort(cells.begin(), cells.end(), stronger);
+      return cells;
+    }
+
+    void
+    cell_search::correlate_pss(const gr_complex* in, int len)
+    {
+      std::fill(d_fold.begin(), d_fold.end(), 0.0f);
+      std::fill(d_fold_cfo.begin(), d_fold_cfo.end(), gr_complex(0.0f, 0.0f));
+      std::fill(d_energy.begin(), d_energy.end(), 0.0);
+
+      const int half = d_fftl / 2;
+      // positions with the complete PSS in the buffer
+      const int npos = len - d_fftl + 1;
+
+      for(int s = 0; s < npos; s += d_step){
+        // overlap-save: the first 3 * fftl + 1 correlation values of a
+        // block are valid for both kernel halves
+        const int nvalid = std::min(d_step, npos - s);
+        const int ncopy = std::min(d_nfft, len - s);
+        memcpy(d_fft->fft_in, in + s, sizeof(gr_complex) * ncopy);
+        memset(d_fft->fft_in + ncopy, 0, sizeof(gr_complex) * (d_nfft - ncopy));
+        fftwf_execute(d_fft->plan_f);
+        for(int k = 0; k < 6; k++){
+          volk_32fc_x2_multiply_32fc(d_fft->prod + k * d_nfft, d_fft->fft_out, d_fft->kernels + k * d_nfft, d_nfft);
+        }
+        fftwf_execute(d_fft->plan_r);
+
+        // window energy as moving sum, recalculated per block
+        double energy = 0.0;
+        for(int i = 0; i < d_fftl; i++){
+          energy += std::norm(in[s + i]);
+        }
+
+        for(int i = 0; i < nvalid; i++){
+          const int n = s + i;
+          const int f = n % d_halffl;
+          for(int id = 0; id < 3; id++){
+            const gr_complex a = d_fft->corr[2 * id * d_nfft + i];
+            const gr_complex b = d_fft->corr[(2 * id + 1) * d_nfft + i + half];
+            // halves are added non-coherently, CFO rotates them against each other
+            const float p = std::abs(a) + std::abs(b);
+            d_fold[id * d_halffl + f] += p * p;
+            d_fold_cfo[id * d_halffl + f] += std::conj(a) * b;
+          }
+          d_energy[f] += energy;
+          if(n + d_fftl < len){
+            energy += std::norm(in[n + d_fftl]) - std::norm(in[n]);
+          }
+        }
+      }
+    }
+
+    void
+    cell_search::find_candidates(std::vector<candidate> &cands)
+    {
+      // echoes within the CP belong to the same peak
+      const int excl = std::max(d_cpl, 1);
+      std::vector<float> rho(d_halffl);
+
+      for(int id = 0; id < 3; id++){
+        const float* fold = &d_fold[id * d_halffl];
+        for(int f = 0; f < d_halffl; f++){
+          rho[f] = d_energy[f] > 0.0 ? fold[f] / (d_energy[f] * d_pss_energy) : 0.0f;
+        }
+
+        for(int c = 0; c < d_max_cells; c++){
+          int pos = std::max_element(rho.begin(), rho.end()) - rho.begin();
+          if(rho[pos] < d_threshold){
+            break;
+          }
+          candidate cand;
+          cand.N_id_2 = id;
+          cand.pos = pos;
+          cand.corr = rho[pos];
+          cands.push_back(cand);
+          for(int e = -excl; e <= excl; e++){
+            rho[(pos + e + d_halffl) % d_halffl] = 0.0f;
+          }
+        }
+      }
+    }
+
+    bool
+    cell_search::decode_cell(const gr_complex* in, int len, const candidate &cand, cell_info &cell)
+    {
+      const int id = cand.N_id_2;
+      // phase of conj(first half) * second half is pi * cfo / 15 kHz
+      float cfo = std::arg(d_fold_cfo[id * d_halffl + cand.pos]) * 15000.0f / M_PI;
+
+      gr_complex pss_bins[62];
+      gr_complex sss_bins[62];
+      gr_complex h[62];
+      // equalized SSS summed over the even and odd half frames of the candidate,
+      // which carry the same sequence as long as the channel is steady
+      gr_complex sss[2][62];
+      std::fill(&sss[0][0], &sss[0][0] + 2 * 62, gr_complex(0.0f, 0.0f));
+      double corr_pwr = 0.0;
+      double pwr = 0.0;
+
+      for(long p = cand.pos, k = 0; p + d_fftl <= len; p += d_halffl, k++){
+        const long s = p - d_fftl - d_cpl;
+        if(s < 0){
+          continue;
+        }
+        symbol_bins(pss_bins, in + p, p, cfo);
+        symbol_bins(sss_bins, in + s, s, cfo);
+
+        // channel estimate Y * conj(PSS), averaged over neighbouring subcarriers
+        gr_complex corr(0.0f, 0.0f);
+        for(int c = 0; c < 62; c++){
+          h[c] = pss_bins[c] * std::conj(d_pss_f[id][c]);
+          corr += h[c];
+          pwr += std::norm(pss_bins[c]);
+        }
+        corr_pwr += std::norm(corr);
+
+        // SSS is equalized by conj(H)
+        gr_complex* acc = sss[k % 2];
+        for(int c = 0; c < 62; c++){
+          gr_complex h_av(0.0f, 0.0f);
+          for(int e = std::max(c - d_H_AVG, 0); e <= std::min(c + d_H_AVG, 61); e++){
+            h_av += h[e];
+          }
+          acc[c] += sss_bins[c] * std::conj(h_av);
+        }
+      }
+
+      int parity;
+      float quality;
+      const int N_id_1 = d_sss->decode(sss[0], sss[1], id, parity, quality);
+      if(quality < d_MIN_Q){
+        return false;
+      }
+
+      // The SSS is a second pilot fftl + cpl samples before the PSS. The
+      // residual CFO turns the equalized SSS by -2 pi * cfo * (fftl + cpl) / fs.
+      float seq[62];
+      gr_complex rot(0.0f, 0.0f);
+      for(int i = 0; i < 2; i++){
+        d_sss->sequence(seq, N_id_1, id, (parity + i) % 2 == 0 ? 0 : 5);
+        for(int c = 0; c < 62; c++){
+          rot += sss[i][c] * seq[c];
+        }
+      }
+      cfo -= std::arg(rot) * 15000.0f * d_fftl / (2.0f * M_PI * (d_fftl + d_cpl));
+
+      const long frame_len = 2 * d_halffl;
+      cell.cell_id = 3 * N_id_1 + id;
+      cell.frame_start = ((cand.pos - d_pss_off + parity * d_halffl) % frame_len + frame_len) % frame_len;
+      cell.cfo = cfo;
+      // |SUM Y * conj(PSS)|^2 / (62 * SUM |Y|^2) is S / (S + N) for a flat channel
+      double rho = corr_pwr / (62.0 * pwr);
+      rho = std::min(rho, 0.9999);
+      cell.snr = 10.0 * std::log10(rho / (1.0 - rho));
+      cell.pss_corr = cand.corr;
+      return true;
+    }
+
+    void
+    cell_search::symbol_bins(gr_complex* out, const gr_complex* in, long pos, float cfo)
+    {
+      // derotate with the phase of the absolute sample position, PSS and SSS stay coherent
+      const double w = -2.0 * M_PI * cfo / (15000.0 * d_fftl);
+      for(int i = 0; i < d_fftl; i++){
+        d_fft->sym_in[i] = in[i] * std::polar(1.0f, float(std::fmod(w * (pos + i), 2.0 * M_PI)));
+      }
+      fftwf_execute(d_fft->plan_sym);
+      for(int c = 0; c < 62; c++){
+        out[c] = d_fft->sym_out[d_bin[c]];
+      }
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
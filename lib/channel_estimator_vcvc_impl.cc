@@ -26,8 +26,10 @@
 #include "channel_estimator_vcvc_impl.h"
 
 #include <volk/volk.h>
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <stdexcept>
 #include <string>
 
 namespace gr {
@@ -39,12 +41,12 @@ namespace gr {
         std::string msg_buf_name,
         const std::vector<std::vector<int> > &pilot_carriers,
         const std::vector<std::vector<gr_complex> > &pilot_symbols,
-        std::string name)
+        std::string name, bool complex_interp)
     {
       return gnuradio::get_initial_sptr(
           new channel_estimator_vcvc_impl(rxant, subcarriers, tag_key,
                                           msg_buf_name, pilot_carriers,
-                                          pilot_symbols, name));
+                                          pilot_symbols, name, complex_interp));
     }
 
     /*
@@ -55,14 +57,15 @@ namespace gr {
         std::string msg_buf_name,
         const std::vector<std::vector<int> > &pilot_carriers,
         const std::vector<std::vector<gr_complex> > &pilot_symbols,
-        std::string name) :
+        std::string name, bool complex_interp) :
         gr::sync_block(
             name /*"channel_estimator_vcvc"*/,
             gr::io_signature::make(1, 1,
                                    sizeof(gr_complex) * subcarriers * rxant),
             gr::io_signature::make(1, 1,
                                    sizeof(gr_complex) * subcarriers * rxant)), d_subcarriers(
-            subcarriers), d_last_calced_sym(-1), d_rxant(rxant)
+            subcarriers), d_last_calced_sym(-1), d_rxant(rxant), d_complex_interp(
+            complex_interp)
     {
       d_key = pmt::string_to_symbol(tag_key); // specify key of tag.
       d_msg_buf = pmt::mp(msg_buf_name);
@@ -71,7 +74,9 @@ namespace gr {
           d_msg_buf,
           boost::bind(&channel_estimator_vcvc_impl::handle_msg, this, _1));
 
+      init_subcarrier_dependend_volk_vectors(subcarriers);
       set_pilot_map(pilot_carriers, pilot_symbols);
+      apply_pending_pilot_map();
     }
 
     /*
@@ -89,6 +94,8 @@ namespace gr {
       const gr_complex *in = (const gr_complex *) input_items[0];
       gr_complex *out = (gr_complex *) output_items[0];
 
+      apply_pending_pilot_map();
+
       std::vector<gr::tag_t> v_b;
       get_tags_in_range(v_b, 0, nitems_read(0), nitems_read(0) + noutput_items,
                         d_key);
@@ -159,7 +166,9 @@ namespace gr {
                                            rx);
         calculate_interpolated_ofdm_symbols(last_calced_sym, processable_items,
                                             rx);
-        processed_items_to_complex(first_sym, processable_items, rx);
+        if(!d_complex_interp){
+          processed_items_to_complex(first_sym, processable_items, rx);
+        }
       }
       return processable_items;
     }
@@ -171,14 +180,21 @@ namespace gr {
       int sym = first_sym;
       for(int i = first_sym; i - first_sym <= processable_items; i++){
         sym = i % d_n_frame_syms;
-        if(d_pilot_carriers[sym].size() > 0){
+        if(d_map->has_pilots(sym)){
           //printf("calc_ofdm_sym = %i\n", sym);
-          memcpy(d_rx_vec,
+          if(d_complex_interp){
+            estimate_ofdm_symbol_complex(
+                d_estimates[rx][sym],
+                in_rx + ((i - first_sym) * d_rxant + rx) * d_subcarriers, sym);
+            d_last_calced_sym = sym;
+            continue;
+          }
+          memcpy(d_rx_vec.data(),
                  in_rx + ((i - first_sym) * d_rxant + rx) * d_subcarriers,
                  sizeof(gr_complex) * d_subcarriers);
           estimate_ofdm_symbol(d_mag_estimates[rx][sym],
-                               d_phase_estimates[rx][sym], d_rx_vec,
-                               d_pilot_carriers[sym], d_pilot_symbols[sym]);
+                               d_phase_estimates[rx][sym], d_rx_vec.data(),
+                               d_map->carriers[sym], d_map->pilot_symbols(sym));
           d_last_calced_sym = sym;
         }
       }
@@ -190,14 +206,21 @@ namespace gr {
     {
       int current_sym = first_sym;
       int next_sym = first_sym;
-      phase_bound_between_pilot_vectors(first_sym, processable_items, rx);
+      if(!d_complex_interp){
+        phase_bound_between_pilot_vectors(first_sym, processable_items, rx);
+      }
 
       for(int i = first_sym; i - first_sym < processable_items; i++){
         current_sym = i % d_n_frame_syms;
-        if(d_pilot_carriers[current_sym].size() > 0){
+        if(d_map->has_pilots(current_sym)){
           for(int n = i + 1; n - first_sym <= processable_items; n++){
             next_sym = n % d_n_frame_syms;
-            if(d_pilot_carriers[next_sym].size() > 0){
+            if(d_map->has_pilots(next_sym)){
+              if(d_complex_interp){
+                interpolate_between_vectors(d_estimates[rx], current_sym,
+                                            next_sym);
+                break;
+              }
               interpolate_between_vectors(d_mag_estimates[rx], current_sym,
                                           next_sym);
               interpolate_between_vectors(d_phase_estimates[rx], current_sym,
@@ -231,7 +254,7 @@ namespace gr {
     {
       int processable_items = 0;
       for(int i = sym_num; i - sym_num < nitems; i++){
-        if(d_pilot_carriers[i % d_n_frame_syms].size() > 0){
+        if(d_map->has_pilots(i % d_n_frame_syms)){
           //printf("get_proc_items\tsym_num = %i\n", i);
           processable_items = i - sym_num + 1;
         }
@@ -244,9 +267,9 @@ namespace gr {
                                                           int nitems)
     {
       int last_sym = first_sym;
-      int n_frame_syms = d_pilot_carriers.size();
+      int n_frame_syms = d_n_frame_syms;
       for(int i = first_sym; i - first_sym < nitems; i++){
-        if(d_pilot_carriers[i % n_frame_syms].size() > 0){
+        if(d_map->has_pilots(i % n_frame_syms)){
           //printf("get_last_proc_items\tsym_num = %i\n", i);
           last_sym = i % n_frame_syms;
         }
@@ -254,26 +277,32 @@ namespace gr {
       return last_sym;
     }
 
+    // Works on float and gr_complex vectors. Complex values are
+    // interpolated component wise.
+    template<typename T>
     void inline
     channel_estimator_vcvc_impl::interpolate_between_vectors(
-        std::vector<float*> &estimates, int previous_sym, int current_sym)
+        std::vector<T*> &estimates, int previous_sym, int current_sym)
     {
       //printf("interpolate between %i\t%i\n", previous_sym, current_sym);
+      const int len = d_subcarriers * sizeof(T) / sizeof(float);
       int steps = (current_sym + d_n_frame_syms - previous_sym)
           % d_n_frame_syms;
       float mult_value = 1.0f / float(steps);
-      volk_32f_x2_subtract_32f_a(d_diff_vector, estimates[current_sym],
-                                 estimates[previous_sym], d_subcarriers);
+      volk_32f_x2_subtract_32f_a(d_diff_vector.data(),
+                                 (float*) estimates[current_sym],
+                                 (float*) estimates[previous_sym], len);
       // The following VOLK OP does have serious problems if called _a. DEBUG!
-      volk_32f_s32f_multiply_32f_u(d_div_vector, d_diff_vector, mult_value,
-                                   d_subcarriers); // alignment problems?
+      volk_32f_s32f_multiply_32f_u(d_div_vector.data(), d_diff_vector.data(),
+                                   mult_value, len); // alignment problems?
       int sym = previous_sym;
       int prev_sym = previous_sym;
       for(int i = previous_sym + 1; i < previous_sym + steps; i++){
         sym = i % d_n_frame_syms;
         //printf("interpolate symbol = %i\n", i);
-        volk_32f_x2_add_32f_a(estimates[sym], estimates[prev_sym], d_div_vector,
-                              d_subcarriers);
+        volk_32f_x2_add_32f_a((float*) estimates[sym],
+                              (float*) estimates[prev_sym], d_div_vector.data(),
+                              len);
         prev_sym = sym;
       }
     }
@@ -283,23 +312,52 @@ namespace gr {
     void
     channel_estimator_vcvc_impl::estimate_ofdm_symbol(
         float* mag_est_vec, float* phase_est_vec, gr_complex* symbol_vec,
-        std::vector<int> pilot_pos, gr_complex* pilot_sym)
+        const std::vector<int> &pilot_pos, gr_complex* pilot_sym)
     {
-      extract_pilots(d_rx_rs, symbol_vec, pilot_pos);
+      extract_pilots(d_rx_rs.data(), symbol_vec, pilot_pos);
       int num_pilots = pilot_pos.size();
-      calculate_mag_phase_diff(d_diff_mag, d_diff_phase, d_rx_rs, pilot_sym,
-                               num_pilots);
-      phase_bound_diff(d_diff_phase, num_pilots);
+      calculate_mag_phase_diff(d_diff_mag.data(), d_diff_phase.data(),
+                               d_rx_rs.data(), pilot_sym, num_pilots);
+      phase_bound_diff(d_diff_phase.data(), num_pilots);
 
-      interpolate_ofdm_symbol(mag_est_vec, d_diff_mag, pilot_pos);
-      interpolate_ofdm_symbol(phase_est_vec, d_diff_phase, pilot_pos);
+      interpolate_ofdm_symbol(mag_est_vec, d_diff_mag.data(), pilot_pos);
+      interpolate_ofdm_symbol(phase_est_vec, d_diff_phase.data(), pilot_pos);
       phase_bound_abs(phase_est_vec, d_subcarriers);
     }
 
+    // Estimate channel for 1 OFDM symbol with RS symbols
+    // Estimates are linearly interpolated between the 2 closest pilots
+    // est = left + w * (right - left) with precalculated indices and weights.
+    void
+    channel_estimator_vcvc_impl::estimate_ofdm_symbol_complex(
+        gr_complex* est_vec, const gr_complex* symbol_vec, int sym)
+    {
+      const std::vector<int> &pilot_pos = d_map->carriers[sym];
+      extract_pilots(d_rx_rs.data(), symbol_vec, pilot_pos);
+      volk_32fc_x2_multiply_conjugate_32fc_a(d_diff_rx_rs.data(),
+                                             d_rx_rs.data(),
+                                             d_map->pilot_symbols(sym),
+                                             pilot_pos.size());
+
+      const int* left = &d_map->interp_left[sym][0];
+      const int* right = &d_map->interp_right[sym][0];
+      for(int i = 0; i < d_subcarriers; i++){
+        d_left_vec[i] = d_diff_rx_rs[left[i]];
+        d_right_vec[i] = d_diff_rx_rs[right[i]];
+      }
+      volk_32f_x2_subtract_32f_a((float*) d_right_vec.data(),
+                                 (float*) d_right_vec.data(),
+                                 (float*) d_left_vec.data(), 2 * d_subcarriers);
+      volk_32fc_32f_multiply_32fc_a(d_right_vec.data(), d_right_vec.data(),
+                                    d_map->weights(sym), d_subcarriers);
+      volk_32f_x2_add_32f_a((float*) est_vec, (float*) d_left_vec.data(),
+                            (float*) d_right_vec.data(), 2 * d_subcarriers);
+    }
+
     inline void
     channel_estimator_vcvc_impl::extract_pilots(gr_complex* b_vec,
-                                                gr_complex* a_vec,
-                                                std::vector<int> pilot_pos)
+                                                const gr_complex* a_vec,
+                                                const std::vector<int> &pilot_pos)
     {
       for(int i = 0; i < pilot_pos.size(); i++){
         b_vec[i] = a_vec[pilot_pos[i]];
@@ -318,10 +376,11 @@ namespace gr {
        * mag(a+jb) == 1 in this case and therefore a^2+b^2 == 1
        * Calculation is simplified to (x+jy)*(a-jb)
        */
-      volk_32fc_x2_multiply_conjugate_32fc_a(d_diff_rx_rs, rx_rs, pilot_sym,
-                                             num_pilots);
-      volk_32fc_magnitude_32f_a(diff_mag, d_diff_rx_rs, num_pilots);
-      volk_32fc_s32f_atan2_32f_a(diff_phase, d_diff_rx_rs, 1, num_pilots);
+      volk_32fc_x2_multiply_conjugate_32fc_a(d_diff_rx_rs.data(), rx_rs,
+                                             pilot_sym, num_pilots);
+      volk_32fc_magnitude_32f_a(diff_mag, d_diff_rx_rs.data(), num_pilots);
+      volk_32fc_s32f_atan2_32f_a(diff_phase, d_diff_rx_rs.data(), 1,
+                                 num_pilots);
     }
 
     // make sure phase difference between 2 values is within [-PI, PI)
@@ -359,10 +418,10 @@ namespace gr {
       int next_sym = first_sym;
       for(int i = first_sym; i - first_sym < processable_items; i++){
         current_sym = i % d_n_frame_syms;
-        if(d_pilot_carriers[current_sym].size() > 0){
+        if(d_map->has_pilots(current_sym)){
           for(int c = current_sym; c - current_sym <= processable_items; c++){
             next_sym = c % d_n_frame_syms;
-            if(d_pilot_carriers[next_sym].size() > 0){
+            if(d_map->has_pilots(next_sym)){
               phase_bound_between_vectors(d_phase_estimates[rx][current_sym],
                                           d_phase_estimates[rx][next_sym]);
               break;
@@ -376,13 +435,13 @@ namespace gr {
     channel_estimator_vcvc_impl::phase_bound_between_vectors(float* first,
                                                              float* last)
     {
-      volk_32f_x2_subtract_32f_a(d_phase_bound_vector, last, first,
+      volk_32f_x2_subtract_32f_a(d_phase_bound_vector.data(), last, first,
                                  d_subcarriers);
       for(int i = 0; i < d_subcarriers; i++){
-        if(*(d_phase_bound_vector + i) > M_PI){
+        if(d_phase_bound_vector[i] > M_PI){
           *(last + i) -= 2 * M_PI;
         }
-        if(*(d_phase_bound_vector + i) < -M_PI){
+        if(d_phase_bound_vector[i] < -M_PI){
           *(last + i) += 2 * M_PI;
         }
       }
@@ -390,7 +449,7 @@ namespace gr {
 
     void inline
     channel_estimator_vcvc_impl::interpolate_ofdm_symbol(
-        float* b_vec, float* a_vec, std::vector<int> pilot_pos)
+        float* b_vec, float* a_vec, const std::vector<int> &pilot_pos)
     {
       for(int i = 0; i <= pilot_pos.front(); i++){
         b_vec[i] = a_vec[0];
@@ -440,32 +499,69 @@ namespace gr {
       return gr_complex(mag * cos(phase), mag * sin(phase));
     }
 
+    // Two message formats are accepted.
+    // (offsets, positions, values) as s32vector, s32vector and c32vector.
+    //   Pilots of OFDM symbol i are [offsets[i], offsets[i + 1]).
+    // (positions, values) as lists of lists with #f for symbols without pilots.
     inline void
     channel_estimator_vcvc_impl::handle_msg(pmt::pmt_t msg)
     {
-      pmt::pmt_t poss = pmt::nth(0, msg);
-      pmt::pmt_t vals = pmt::nth(1, msg);
-
       std::vector<std::vector<int> > pilot_carriers;
       std::vector<std::vector<gr_complex> > pilot_symbols;
-      msg_extract_poss(pilot_carriers, poss);
-      msg_extract_vals(pilot_symbols, vals);
+      pmt::pmt_t first = pmt::nth(0, msg);
+      if(pmt::is_s32vector(first)){
+        msg_extract_vectors(pilot_carriers, pilot_symbols, first,
+                            pmt::nth(1, msg), pmt::nth(2, msg));
+      }
+      else{
+        msg_extract_poss(pilot_carriers, first);
+        msg_extract_vals(pilot_symbols, pmt::nth(1, msg));
+      }
 
       set_pilot_map(pilot_carriers, pilot_symbols);
       printf("%s PILOT MAP RESETTED!!!\n", name().c_str());
 
     }
 
+    inline void
+    channel_estimator_vcvc_impl::msg_extract_vectors(
+        std::vector<std::vector<int> > &pilot_carriers,
+        std::vector<std::vector<gr_complex> > &pilot_symbols,
+        pmt::pmt_t offsets, pmt::pmt_t poss, pmt::pmt_t vals)
+    {
+      size_t n_offsets, n_poss, n_vals;
+      const int32_t* off = pmt::s32vector_elements(offsets, n_offsets);
+      const int32_t* pos = pmt::s32vector_elements(poss, n_poss);
+      const gr_complex* val = pmt::c32vector_elements(vals, n_vals);
+      if(n_offsets < 1 || n_poss != n_vals || off[n_offsets - 1] != n_poss){
+        throw std::invalid_argument(
+            "channel_estimator_vcvc: inconsistent pilot map message");
+      }
+
+      int n_frame_syms = n_offsets - 1;
+      pilot_carriers.resize(n_frame_syms);
+      pilot_symbols.resize(n_frame_syms);
+      for(int i = 0; i < n_frame_syms; i++){
+        if(off[i] > off[i + 1]){
+          throw std::invalid_argument(
+              "channel_estimator_vcvc: inconsistent pilot map message");
+        }
+        pilot_carriers[i].assign(pos + off[i], pos + off[i + 1]);
+        pilot_symbols[i].assign(val + off[i], val + off[i + 1]);
+      }
+    }
+
     inline void
     channel_estimator_vcvc_impl::msg_extract_poss(
         std::vector<std::vector<int> > &pilot_carriers, pmt::pmt_t poss)
     {
-      for(int i = 0; i < pmt::length((poss)); i++){
-        pmt::pmt_t p_sym = pmt::nth(i, poss);
+      // walk lists with car/cdr, nth would be quadratic.
+      for(; pmt::is_pair(poss); poss = pmt::cdr(poss)){
+        pmt::pmt_t p_sym = pmt::car(poss);
         std::vector<int> v_sym;
         if(!pmt::is_bool(p_sym)){
-          for(int c = 0; c < pmt::length(p_sym); c++){
-            int pos = int(pmt::to_long(pmt::nth(c, p_sym)));
+          for(; pmt::is_pair(p_sym); p_sym = pmt::cdr(p_sym)){
+            int pos = int(pmt::to_long(pmt::car(p_sym)));
             v_sym.push_back(pos);
           }
         }
@@ -477,12 +573,12 @@ namespace gr {
     channel_estimator_vcvc_impl::msg_extract_vals(
         std::vector<std::vector<gr_complex> > &pilot_symbols, pmt::pmt_t vals)
     {
-      for(int i = 0; i < pmt::length((vals)); i++){
-        pmt::pmt_t p_sym = pmt::nth(i, vals);
+      for(; pmt::is_pair(vals); vals = pmt::cdr(vals)){
+        pmt::pmt_t p_sym = pmt::car(vals);
         std::vector<gr_complex> v_sym;
         if(!pmt::is_bool(p_sym)){
-          for(int c = 0; c < pmt::length(p_sym); c++){
-            gr_complex val = gr_complex(pmt::to_complex(pmt::nth(c, p_sym)));
+          for(; pmt::is_pair(p_sym); p_sym = pmt::cdr(p_sym)){
+            gr_complex val = gr_complex(pmt::to_complex(pmt::car(p_sym)));
             //printf("value %i,%i\t%+1.2f %+1.2fj\n", i, c, val.real(), val.imag() );
             v_sym.push_back(val);
           }
@@ -491,21 +587,61 @@ namespace gr {
       }
     }
 
+    // Runs in the message handler thread. Everything depending on the new
+    // pilot map is built here. work() only swaps the pointer.
     void
     channel_estimator_vcvc_impl::set_pilot_map(
         const std::vector<std::vector<int> > &pilot_carriers,
         const std::vector<std::vector<gr_complex> > &pilot_symbols)
     {
       //printf("%s\tset_pilot_map BEGIN\n", name().c_str() );
-      int n_frame_syms = get_nsyms_in_frame(pilot_carriers);
-      int max_pilots = get_max_pilot_number(pilot_carriers);
-      init_pilot_symbol_arrays(pilot_symbols, n_frame_syms, max_pilots);
-      initialize_volk_vectors(max_pilots, d_subcarriers, n_frame_syms);
-
-      d_n_frame_syms = n_frame_syms;
-      d_pilot_carriers = pilot_carriers;
+      pilot_map_sptr map(new pilot_map);
+      map->carriers = pilot_carriers;
+      map->n_frame_syms = get_nsyms_in_frame(pilot_carriers);
+      map->max_pilots = get_max_pilot_number(pilot_carriers);
+      init_pilot_symbol_arrays(*map, pilot_symbols);
+      init_interpolation_tables(*map);
+
+      gr::thread::scoped_lock lock(d_map_mutex);
+      d_pending_map = map;
       //printf("set_pilot_map END\n");
+    }
 
+    std::vector<std::vector<int> >
+    channel_estimator_vcvc_impl::get_pilot_carriers()
+    {
+      gr::thread::scoped_lock lock(d_map_mutex);
+      if(d_pending_map){
+        return d_pending_map->carriers;
+      }
+      return d_map->carriers;
+    }
+
+    // Activate a new pilot map if there is one. Work buffers are resized
+    // in place, i.e. memory is reused if the dimensions did not change.
+    inline void
+    channel_estimator_vcvc_impl::apply_pending_pilot_map()
+    {
+      pilot_map_sptr map;
+      {
+        gr::thread::scoped_lock lock(d_map_mutex);
+        if(!d_pending_map){
+          return;
+        }
+        map.swap(d_pending_map);
+        // get_pilot_carriers() reads d_map under the lock as well.
+        d_map.swap(map);
+      }
+      // The previous map is released when map goes out of scope.
+
+      init_pilot_dependend_volk_vectors(d_map->max_pilots);
+      if(!map || map->n_frame_syms != d_map->n_frame_syms){
+        init_estimates_store_volk_vectors(d_subcarriers, d_map->n_frame_syms);
+      }
+      d_n_frame_syms = d_map->n_frame_syms;
+      if(d_last_calced_sym >= d_n_frame_syms){
+        d_last_calced_sym = -1;
+      }
     }
 
     inline int
@@ -528,94 +664,114 @@ namespace gr {
 
     inline void
     channel_estimator_vcvc_impl::init_pilot_symbol_arrays(
-        const std::vector<std::vector<gr_complex> > &pilot_symbols,
-        int n_frame_syms, int max_pilots)
+        pilot_map &map,
+        const std::vector<std::vector<gr_complex> > &pilot_symbols)
     {
-      d_pilot_symbols.clear();
-      d_pilot_symbols.reserve(n_frame_syms);
-      int alig = volk_get_alignment();
-
-      for(int i = 0; i < n_frame_syms; i++){
-        // aligned arrays for each symbol.
+      // aligned rows for each symbol in one block of memory.
+      map.stride = aligned_buffer<gr_complex>::aligned_len(map.max_pilots);
+      map.symbols.resize(map.n_frame_syms * map.stride);
+      map.symbols.zero();
+      for(int i = 0; i < map.n_frame_syms; i++){
         //printf("set_pilot_sym %i\n", i);
-
-        d_pilot_symbols.push_back(
-            (gr_complex*) volk_malloc(sizeof(gr_complex) * max_pilots, alig));
-        memcpy(d_pilot_symbols[i], &pilot_symbols[i][0],
-               sizeof(gr_complex) * pilot_symbols[i].size());
+        int n = std::min(pilot_symbols[i].size(), map.carriers[i].size());
+        if(n > 0){
+          memcpy(map.pilot_symbols(i), &pilot_symbols[i][0],
+                 sizeof(gr_complex) * n);
+        }
       }
     }
 
-    inline void
-    channel_estimator_vcvc_impl::initialize_volk_vectors(int max_pilots,
-                                                         int subcarriers,
-                                                         int n_frame_syms)
-    {
-
-      init_pilot_dependend_volk_vectors(max_pilots);
-      init_subcarrier_dependend_volk_vectors(subcarriers);
-      init_estimates_store_volk_vectors(subcarriers, n_frame_syms);
-
-    }
-
     inline void
     channel_estimator_vcvc_impl::init_pilot_dependend_volk_vectors(
         int max_pilots)
     {
-      int alig = volk_get_alignment();
-      d_rx_rs = (gr_complex*) volk_malloc(sizeof(gr_complex) * max_pilots,
-                                          alig);
-      d_diff_rx_rs = (gr_complex*) volk_malloc(sizeof(gr_complex) * max_pilots,
-                                               alig);
-      d_diff_mag = (float*) volk_malloc(sizeof(float) * max_pilots, alig);
-      d_diff_phase = (float*) volk_malloc(sizeof(float) * max_pilots, alig);
+      d_rx_rs.resize(max_pilots);
+      d_diff_rx_rs.resize(max_pilots);
+      d_diff_mag.resize(max_pilots);
+      d_diff_phase.resize(max_pilots);
     }
 
     inline void
     channel_estimator_vcvc_impl::init_subcarrier_dependend_volk_vectors(
         int subcarriers)
     {
-      int alig = volk_get_alignment();
-      d_diff_vector = (float*) volk_malloc(sizeof(float) * subcarriers, alig);
-      d_div_vector = (float*) volk_malloc(sizeof(float) * subcarriers, alig);
-      d_rx_vec = (gr_complex*) volk_malloc(sizeof(gr_complex) * subcarriers,
-                                           alig);
-      d_phase_bound_vector = (float*) volk_malloc(sizeof(float) * subcarriers,
-                                                  alig);
+      // twice the size to interpolate complex vectors component wise.
+      d_diff_vector.resize(2 * subcarriers);
+      d_div_vector.resize(2 * subcarriers);
+      d_left_vec.resize(subcarriers);
+      d_right_vec.resize(subcarriers);
+      d_rx_vec.resize(subcarriers);
+      d_phase_bound_vector.resize(subcarriers);
     }
 
     inline void
     channel_estimator_vcvc_impl::init_estimates_store_volk_vectors(
         int subcarriers, int n_frame_syms)
     {
-
-      d_estimates.clear();
-      d_mag_estimates.clear();
-      d_phase_estimates.clear();
-      //printf("capacity\test = %i\tmag = %i\tphase = %i\n", int(d_estimates.capacity()), int(d_mag_estimates.capacity()), int(d_phase_estimates.capacity()) );
-      int alig = volk_get_alignment();
-
+      int cstride = aligned_buffer<gr_complex>::aligned_len(subcarriers);
+      int fstride = aligned_buffer<float>::aligned_len(subcarriers);
+      d_estimates_store.resize(d_rxant * n_frame_syms * cstride);
+      d_mag_estimates_store.resize(d_rxant * n_frame_syms * fstride);
+      d_phase_estimates_store.resize(d_rxant * n_frame_syms * fstride);
+      d_estimates_store.zero();
+      d_mag_estimates_store.zero();
+      d_phase_estimates_store.zero();
+
+      d_estimates.resize(d_rxant);
+      d_mag_estimates.resize(d_rxant);
+      d_phase_estimates.resize(d_rxant);
       for(int rx = 0; rx < d_rxant; rx++){
-        d_estimates.push_back(std::vector<gr_complex*>());
-        d_mag_estimates.push_back(std::vector<float*>());
-        d_phase_estimates.push_back(std::vector<float*>());
-
-        d_estimates[rx].reserve(n_frame_syms);
-        d_mag_estimates[rx].reserve(n_frame_syms);
-        d_phase_estimates[rx].reserve(n_frame_syms);
-
+        d_estimates[rx].resize(n_frame_syms);
+        d_mag_estimates[rx].resize(n_frame_syms);
+        d_phase_estimates[rx].resize(n_frame_syms);
         for(int i = 0; i < n_frame_syms; i++){
-          d_estimates[rx].push_back(
-              (gr_complex*) volk_malloc(sizeof(gr_complex) * subcarriers,
-                                        alig));
-          d_mag_estimates[rx].push_back(
-              (float*) volk_malloc(sizeof(float) * subcarriers, alig));
-          d_phase_estimates[rx].push_back(
-              (float*) volk_malloc(sizeof(float) * subcarriers, alig));
+          int n = rx * n_frame_syms + i;
+          d_estimates[rx][i] = d_estimates_store.data() + n * cstride;
+          d_mag_estimates[rx][i] = d_mag_estimates_store.data() + n * fstride;
+          d_phase_estimates[rx][i] = d_phase_estimates_store.data()
+              + n * fstride;
         }
-
       }
+    }
 
+    inline void
+    channel_estimator_vcvc_impl::init_interpolation_tables(pilot_map &map)
+    {
+      int n_frame_syms = map.n_frame_syms;
+      map.interp_left.assign(n_frame_syms, std::vector<int>());
+      map.interp_right.assign(n_frame_syms, std::vector<int>());
+      map.weight_stride = aligned_buffer<float>::aligned_len(d_subcarriers);
+      map.interp_weight.resize(n_frame_syms * map.weight_stride);
+
+      for(int sym = 0; sym < n_frame_syms; sym++){
+        const std::vector<int> &pos = map.carriers[sym];
+        if(pos.empty()){
+          continue;
+        }
+        std::vector<int> &left = map.interp_left[sym];
+        std::vector<int> &right = map.interp_right[sym];
+        left.resize(d_subcarriers);
+        right.resize(d_subcarriers);
+        float* weight = map.weights(sym);
+
+        // hold first and last pilot value towards the band edges.
+        int p = 0;
+        int last = pos.size() - 1;
+        for(int i = 0; i < d_subcarriers; i++){
+          while(p < last && i >= pos[p + 1]){
+            p++;
+          }
+          if(i < pos[p] || p == last){
+            left[i] = right[i] = p;
+            weight[i] = 0.0f;
+          }
+          else{
+            left[i] = p;
+            right[i] = p + 1;
+            weight[i] = float(i - pos[p]) / float(pos[p + 1] - pos[p]);
+          }
+        }
+      }
     }
 
   } /* namespace lte */
@@ -22,6 +22,9 @@
 #define INCLUDED_LTE_CHANNEL_ESTIMATOR_VCVC_IMPL_H
 
 #include <lte/channel_estimator_vcvc.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/shared_ptr.hpp>
+#include "aligned_buffer.h"
 
 namespace gr {
   namespace lte {
@@ -34,29 +37,60 @@ namespace gr {
       int d_n_frame_syms;
       int d_last_calced_sym;
       int d_rxant;
+      bool d_complex_interp;
       pmt::pmt_t d_key;
       pmt::pmt_t d_msg_buf;
 
       inline void
       handle_msg(pmt::pmt_t msg);
       inline void
+      msg_extract_vectors(std::vector<std::vector<int> > &pilot_carriers,
+                          std::vector<std::vector<gr_complex> > &pilot_symbols,
+                          pmt::pmt_t offsets, pmt::pmt_t poss, pmt::pmt_t vals);
+      inline void
       msg_extract_poss(std::vector<std::vector<int> > &pilot_carriers,
                        pmt::pmt_t poss);
       inline void
       msg_extract_vals(std::vector<std::vector<gr_complex> > &pilot_symbols,
                        pmt::pmt_t vals);
 
-      std::vector<std::vector<int> > d_pilot_carriers;
-      std::vector<gr_complex*> d_pilot_symbols;
+      // Pilot positions and values plus all tables derived from them.
+      // A new map is built completely by the message handler and handed
+      // over to work() by swapping a pointer.
+      struct pilot_map : boost::noncopyable
+      {
+        std::vector<std::vector<int> > carriers;
+        int n_frame_syms;
+        int max_pilots;
+        // pilot values, one aligned row per OFDM symbol
+        int stride;
+        aligned_buffer<gr_complex> symbols;
+        // Per pilot symbol: index of left and right pilot for each subcarrier
+        // and the weight of the right one.
+        std::vector<std::vector<int> > interp_left;
+        std::vector<std::vector<int> > interp_right;
+        int weight_stride;
+        aligned_buffer<float> interp_weight;
+
+        gr_complex* pilot_symbols(int sym) { return symbols.data() + sym * stride; }
+        float* weights(int sym) { return interp_weight.data() + sym * weight_stride; }
+        bool has_pilots(int sym) const { return !carriers[sym].empty(); }
+      };
+      typedef boost::shared_ptr<pilot_map> pilot_map_sptr;
+
+      pilot_map_sptr d_map;
+      pilot_map_sptr d_pending_map;
+      gr::thread::mutex d_map_mutex;
 
       // These methods do all the setup stuff.
       inline void
       init_pilot_symbol_arrays(
-          const std::vector<std::vector<gr_complex> > &pilot_symbols,
-          int n_frame_syms, int max_pilots);
+          pilot_map &map,
+          const std::vector<std::vector<gr_complex> > &pilot_symbols);
+      inline void
+      init_interpolation_tables(pilot_map &map);
       inline void
-      initialize_volk_vectors(int max_pilots, int subcarriers,
-                              int n_frame_syms);
+      apply_pending_pilot_map();
       inline void
       init_pilot_dependend_volk_vectors(int max_pilots);
       inline void
@@ -64,6 +98,11 @@ namespace gr {
       inline void
       init_estimates_store_volk_vectors(int subcarriers, int n_frame_syms);
 
+      // Estimates of all symbols in a frame live in one arena per antenna
+      // which is reused as long as the frame dimensions do not change.
+      aligned_buffer<gr_complex> d_estimates_store;
+      aligned_buffer<float> d_mag_estimates_store;
+      aligned_buffer<float> d_phase_estimates_store;
       std::vector<std::vector<gr_complex*> > d_estimates;
       std::vector<std::vector<float*> > d_mag_estimates;
       std::vector<std::vector<float*> > d_phase_estimates;
@@ -88,7 +127,7 @@ namespace gr {
       inline void
       calculate_ofdm_symbols_with_pilots(const gr_complex* in_rx, int first_sym,
                                          int processable_items, int rx);
-      gr_complex* d_rx_vec;
+      aligned_buffer<gr_complex> d_rx_vec;
       inline void
       calculate_interpolated_ofdm_symbols(int first_sym, int processable_items,
                                           int rx);
@@ -102,21 +141,29 @@ namespace gr {
       // Calculate phase and magnitude distortion for OFDM symbol with
       void
       estimate_ofdm_symbol(float* mag_est_vec, float* phase_est_vec,
-                           gr_complex* symbol_vec, std::vector<int> pilot_pos,
+                           gr_complex* symbol_vec,
+                           const std::vector<int> &pilot_pos,
                            gr_complex* pilot_sym);
-      gr_complex* d_rx_rs;
-      float* d_diff_mag;
-      float* d_diff_phase;
+
+      // Same as above but interpolation is done on complex values.
+      void
+      estimate_ofdm_symbol_complex(gr_complex* est_vec,
+                                   const gr_complex* symbol_vec, int sym);
+      aligned_buffer<gr_complex> d_left_vec;
+      aligned_buffer<gr_complex> d_right_vec;
+      aligned_buffer<gr_complex> d_rx_rs;
+      aligned_buffer<float> d_diff_mag;
+      aligned_buffer<float> d_diff_phase;
 
       inline void
       calculate_mag_phase_diff(float* diff_mag, float* diff_phase,
                                gr_complex* rx_rs, gr_complex* pilot_sym,
                                int num_pilots);
-      gr_complex* d_diff_rx_rs;
+      aligned_buffer<gr_complex> d_diff_rx_rs;
 
       inline void
-      extract_pilots(gr_complex* b_vec, gr_complex* a_vec,
-                     std::vector<int> pilot_pos);
+      extract_pilots(gr_complex* b_vec, const gr_complex* a_vec,
+                     const std::vector<int> &pilot_pos);
 
       void inline
       phase_bound_diff(float* phase_vec, int len);
@@ -127,17 +174,18 @@ namespace gr {
                                         int rx);
       void inline
       phase_bound_between_vectors(float* first, float* last);
-      float* d_phase_bound_vector;
+      aligned_buffer<float> d_phase_bound_vector;
 
+      template<typename T>
       void inline
-      interpolate_between_vectors(std::vector<float*> &estimates,
+      interpolate_between_vectors(std::vector<T*> &estimates,
                                   int previous_sym, int current_sym);
-      float* d_diff_vector;
-      float* d_div_vector;
+      aligned_buffer<float> d_diff_vector;
+      aligned_buffer<float> d_div_vector;
 
       void inline
       interpolate_ofdm_symbol(float* b_vec, float* a_vec,
-                              std::vector<int> pilot_pos);
+                              const std::vector<int> &pilot_pos);
       void inline
       interpolate(float* interp_vals, float first_val, float last_val,
                   int steps);
@@ -154,7 +202,7 @@ namespace gr {
           std::string msg_buf_name,
           const std::vector<std::vector<int> > &pilot_carriers,
           const std::vector<std::vector<gr_complex> > &pilot_symbols,
-          std::string name);
+          std::string name, bool complex_interp);
       ~channel_estimator_vcvc_impl();
 
       // Where all the action really happens
@@ -167,10 +215,7 @@ namespace gr {
                     const std::vector<std::vector<gr_complex> > &pilot_symbols);
 
       std::vector<std::vector<int> >
-      get_pilot_carriers()
-      {
-        return d_pilot_carriers;
-      }
+      get_pilot_carriers();
 
     };
 
@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "cp_correlator.h"
+#include <volk/volk.h>
+
+namespace gr {
+  namespace lte {
+
+    gr_complex
+    cp_correlator::corr(const gr_complex* x, const gr_complex* y, int len)
+    {
+      gr_complex res(0.0f, 0.0f);
+      volk_32fc_x2_conjugate_dot_prod_32fc(&res, x, y, len);
+      return res;
+    }
+
+    void
+    cp_correlator::sliding_corr(gr_complex* out, const gr_complex* in,
+                                int lag, int len, int stride, int n)
+    {
+      //windows do not overlap, nothing to reuse
+      if(stride >= len){
+        for(int i = 0; i < n; i++){
+          const gr_complex* x = in + i * stride;
+          out[i] = corr(x, x + lag, len);
+        }
+        return;
+      }
+
+      gr_complex acc(0.0f, 0.0f);
+      for(int i = 0; i < n; i++){
+        const gr_complex* x = in + i * stride;
+        if(i % d_RESEED == 0){
+          acc = corr(x, x + lag, len);
+        }
+        else{
+          const gr_complex* enter = x + len - stride;
+          const gr_complex* leave = x - stride;
+          acc += corr(enter, enter + lag, stride) - corr(leave, leave + lag, stride);
+        }
+        out[i] = acc;
+      }
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
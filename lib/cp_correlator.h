@@ -0,0 +1,56 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_CP_CORRELATOR_H
+#define INCLUDED_LTE_CP_CORRELATOR_H
+
+#include <gnuradio/gr_complex.h>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief Cyclic prefix correlation kernels
+     *
+     * corr() is SUM x[k] * conj(y[k]), calculated in place without
+     * scratch memory. sliding_corr() calculates a series of windows of in
+     * correlated with in + lag, e.g. CP and symbol end for lag = fftl. Windows
+     * start stride values apart. Overlapping windows are updated as a
+     * moving sum: only stride products enter and leave per step.
+     */
+    class cp_correlator
+    {
+    public:
+      static gr_complex corr(const gr_complex* x, const gr_complex* y, int len);
+
+      // out[i] = corr(in + i * stride, in + i * stride + lag, len) for i in [0, n)
+      static void sliding_corr(gr_complex* out, const gr_complex* in,
+                               int lag, int len, int stride, int n);
+
+    private:
+      // the moving sum is recalculated every d_RESEED steps to limit rounding errors
+      static const int d_RESEED = 256;
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_CP_CORRELATOR_H */
+
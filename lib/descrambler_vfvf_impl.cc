@@ -28,6 +28,7 @@
 #include <fftw3.h>
 #include <volk/volk.h>
 #include <boost/format.hpp>
+#include <algorithm>
 
 namespace gr {
   namespace lte {
@@ -47,6 +48,8 @@ namespace gr {
               gr::io_signature::make(1, 1, sizeof(float) * len),
               gr::io_signature::make(1, 1, sizeof(float) * len)),
               d_len(len),
+              d_scr_seq_len(0),
+              d_num_seqs(0),
               d_seq_index(0),
               d_part(0)
     {
@@ -55,6 +58,10 @@ namespace gr {
         d_msg_buf = pmt::mp(msg_buf_name);
         message_port_register_in(d_msg_buf);
         set_msg_handler(d_msg_buf, boost::bind(&descrambler_vfvf_impl::handle_msg, this, _1));
+
+        // Items are aligned if the buffer start is aligned and an item
+        // is a multiple of the alignment. Sequence rows always are.
+        d_aligned = (sizeof(float) * len) % volk_get_alignment() == 0;
     }
 
     /*
@@ -72,22 +79,38 @@ namespace gr {
     	const float *in = (const float *) input_items[0];
     	float *out = (float *) output_items[0];
 
+        apply_pending_table();
+        if(!d_table){
+            return 0;
+        }
 
-        int scr_pos = 0;
-        int max_parts = d_scr_seq_len/d_len;
+        // Fetch all tags of this call once and walk them along the items.
+        const uint64_t nread = nitems_read(0);
+        std::vector <gr::tag_t> v_b;
+        get_tags_in_range(v_b, 0, nread, nread + noutput_items, d_tag_key);
+        std::sort(v_b.begin(), v_b.end(), gr::tag_t::offset_compare);
+        std::vector<gr::tag_t>::const_iterator tag = v_b.begin();
 
-        int seq_num = get_seq_num(0);
+        const int max_parts = d_scr_seq_len / d_len;
+        const bool aligned = d_aligned && !is_unaligned();
         int part = d_part;
 
         for(int i = 0; i < noutput_items; i++){
-            int next = get_seq_num(i);
-            if(seq_num !=  next){
-                part = 0;
-                seq_num = next;
+            // A tag marks the first item of sequence 'value'.
+            for(; tag != v_b.end() && tag->offset <= nread + i; ++tag){
+                if(tag->offset == nread + i){
+                    int value = int(pmt::to_long(tag->value));
+                    d_seq_index = (value % d_num_seqs + d_num_seqs) % d_num_seqs;
+                    part = 0;
+                }
+            }
+            const float* seq = d_table->seq(d_seq_index) + part * d_len;
+            if(aligned){
+                volk_32f_x2_multiply_32f_a(out, in, seq, d_len);
+            }
+            else{
+                volk_32f_x2_multiply_32f_u(out, in, seq, d_len);
             }
-            scr_pos = part * d_len;
-            float* seq = &d_scr_seq_vec[seq_num][scr_pos];
-            volk_32f_x2_multiply_32f_u(out, in, seq, d_len);
             part = (part+1)%(max_parts);
             out += d_len;
             in += d_len;
@@ -97,48 +120,32 @@ namespace gr {
         // Tell runtime system how many output items we produced.
         return noutput_items;
     }
-    
-    int
-    descrambler_vfvf_impl::get_seq_num(int idx)
-    {
-        int seq_num = 0;
-        int pos = nitems_read(0)+idx;
-        std::vector <gr::tag_t> v_b;
-        get_tags_in_range(v_b, 0, pos, pos+1, d_tag_key);
-        if(v_b.size() > 0){
-            //std::string srcid = "srcid"; //pmt::pmt_symbol_to_string(v_b[0].srcid );
-            long offset = v_b[0].offset;
-            int value = int(pmt::to_long(v_b[0].value) );
-            seq_num = (value - int(offset-pos) +d_num_seqs)%d_num_seqs;
-            d_seq_index = seq_num;
-            d_part = 0;
-    //        printf("NEW\t");
-        }
-        else{
-            seq_num = d_seq_index;
-    //        printf("OLD\t");
-        }
-    //    printf("get_seq_num = %i\tidx = %i\tpos = %i\n", seq_num, idx, pos);
-        return seq_num;
-    }
 
+    // Accepts a pair (num_seqs . f32vector) with all sequences in one table
+    // or a vector of vectors of doubles with one sequence each.
     void
     descrambler_vfvf_impl::handle_msg(pmt::pmt_t msg)
     {
-        pmt::print(msg);
+        if(pmt::is_pair(msg) && pmt::is_f32vector(pmt::cdr(msg))){
+            size_t len;
+            const float* seqs = pmt::f32vector_elements(pmt::cdr(msg), len);
+            int num_seqs = int(pmt::to_long(pmt::car(msg)));
+            if(num_seqs < 1 || len % num_seqs != 0){
+                throw std::runtime_error("descrambler_vfvf: table size is not a multiple of num_seqs\n");
+            }
+            set_descr_table(seqs, num_seqs, len / num_seqs);
+            return;
+        }
         if(! pmt::is_vector(msg)){
             throw std::runtime_error("message doesn't have vector type! Can't use it!\n");
         }
         printf("%s received msg", name().c_str());
         std::vector<std::vector<float> > seqs;
         for(int i = 0; i < pmt::length(msg); i++){
-//            printf("vector num = %i of %lu\n", i, pmt::length(msg));
             pmt::pmt_t pmt_vec = pmt::vector_ref(msg, i);
             std::vector<float> vec;
             for(int e = 0; e < pmt::length(pmt_vec); e++){
-                float elem = (float)pmt::to_double(pmt::vector_ref(pmt_vec, e));
-//                printf("ns = %i, e = %i, val = %f\n", i, e, elem);
-                vec.push_back(/*pmt::f32vector_ref(pmt_vec, e)*/ elem);
+                vec.push_back(float(pmt::to_double(pmt::vector_ref(pmt_vec, e))));
             }
             seqs.push_back(vec);
         }
@@ -149,22 +156,48 @@ namespace gr {
     descrambler_vfvf_impl::set_descr_seqs(std::vector<std::vector<float> > seqs)
     {
         GR_LOG_INFO(d_debug_logger, "set_descr_seqs\n");
-        d_scr_seq_len = seqs[0].size();
-        d_num_seqs = seqs.size();
-
-        std::vector<float*> aligned_seqs;
+        int seq_len = seqs[0].size();
+        std::vector<float> table(seqs.size() * seq_len);
         for(int n = 0; n < seqs.size(); n++) {
-            aligned_seqs.push_back(get_aligned_sequence(seqs[n]));
+            memcpy(&table[n * seq_len], &seqs[n][0], sizeof(float) * seq_len);
+        }
+        set_descr_table(&table[0], seqs.size(), seq_len);
+    }
+
+    void
+    descrambler_vfvf_impl::set_descr_table(const float* seqs, int num_seqs, int seq_len)
+    {
+        seq_table_sptr table(new seq_table);
+        table->num_seqs = num_seqs;
+        table->seq_len = seq_len;
+        table->stride = aligned_buffer<float>::aligned_len(seq_len);
+        table->seqs.resize(num_seqs * table->stride);
+        for(int n = 0; n < num_seqs; n++) {
+            memcpy(table->seq(n), seqs + n * seq_len, sizeof(float) * seq_len);
         }
-        d_scr_seq_vec = aligned_seqs;
+
+        gr::thread::scoped_lock lock(d_table_mutex);
+        d_pending_table = table;
     }
 
-    float*
-    descrambler_vfvf_impl::get_aligned_sequence(std::vector<float> seq)
+    inline void
+    descrambler_vfvf_impl::apply_pending_table()
     {
-        float* vec = (float*)fftwf_malloc(sizeof(float)*seq.size() );
-        memcpy(vec, &seq[0], sizeof(float)*seq.size() );
-        return vec;
+        seq_table_sptr table;
+        {
+            gr::thread::scoped_lock lock(d_table_mutex);
+            if(!d_pending_table){
+                return;
+            }
+            table.swap(d_pending_table);
+        }
+        d_table.swap(table);
+        d_scr_seq_len = d_table->seq_len;
+        d_num_seqs = d_table->num_seqs;
+        d_seq_index %= d_num_seqs;
+        if(d_part >= d_scr_seq_len / d_len){
+            d_part = 0;
+        }
     }
 
   } /* namespace lte */
@@ -22,6 +22,9 @@
 #define INCLUDED_LTE_DESCRAMBLER_VFVF_IMPL_H
 
 #include <lte/descrambler_vfvf.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/shared_ptr.hpp>
+#include "aligned_buffer.h"
 
 namespace gr {
   namespace lte {
@@ -32,16 +35,32 @@ namespace gr {
         pmt::pmt_t d_tag_key;
         pmt::pmt_t d_msg_buf;
         int d_len;
+        bool d_aligned;
+
+        // All sequences in one aligned table, one row per sequence.
+        // New tables are handed over to work() by swapping a pointer.
+        struct seq_table : boost::noncopyable
+        {
+          int num_seqs;
+          int seq_len;
+          int stride;
+          aligned_buffer<float> seqs;
+
+          float* seq(int n) { return seqs.data() + n * stride; }
+        };
+        typedef boost::shared_ptr<seq_table> seq_table_sptr;
+        seq_table_sptr d_table;
+        seq_table_sptr d_pending_table;
+        gr::thread::mutex d_table_mutex;
 
-        std::vector<float*> d_scr_seq_vec;
         int d_scr_seq_len;
         int d_num_seqs;
         int d_seq_index;
         int d_part;
 
         inline void handle_msg(pmt::pmt_t msg);
-        float* get_aligned_sequence(std::vector<float> seq);
-        int get_seq_num(int idx);
+        void set_descr_table(const float* seqs, int num_seqs, int seq_len);
+        inline void apply_pending_table();
 
      public:
       descrambler_vfvf_impl(std::string& name, std::string tag_key, std::string msg_buf_name, int len);
@@ -0,0 +1,174 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "freq_rotator_cc_impl.h"
+
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gr {
+  namespace lte {
+
+    freq_rotator_cc::sptr
+    freq_rotator_cc::make(int rxant, double samp_rate, std::string name)
+    {
+      return gnuradio::get_initial_sptr
+        (new freq_rotator_cc_impl(rxant, samp_rate, name));
+    }
+
+    /*
+     * The private constructor
+     */
+    freq_rotator_cc_impl::freq_rotator_cc_impl(int rxant, double samp_rate, std::string name)
+      : gr::sync_block(name,
+              gr::io_signature::make( 1, 8, sizeof(gr_complex)),
+              gr::io_signature::make( 1, 8, sizeof(gr_complex))),
+              d_rxant(rxant),
+              d_samp_rate(samp_rate),
+              d_freq(0.0),
+              d_phase(1.0f, 0.0f),
+              d_phase_inc(1.0f, 0.0f)
+    {
+        d_freq_key = pmt::string_to_symbol("freq");
+
+        message_port_register_in(pmt::mp("freq"));
+        set_msg_handler(pmt::mp("freq"), boost::bind(&freq_rotator_cc_impl::handle_msg_freq, this, _1));
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    freq_rotator_cc_impl::~freq_rotator_cc_impl()
+    {
+    }
+
+    void
+    freq_rotator_cc_impl::handle_msg_freq(pmt::pmt_t msg)
+    {
+        if(pmt::is_pair(msg)){
+            add_update(pmt::to_uint64(pmt::car(msg)), pmt::to_double(pmt::cdr(msg)));
+        }
+        else{
+            add_update(0, pmt::to_double(msg));
+        }
+    }
+
+    void
+    freq_rotator_cc_impl::set_freq(double freq)
+    {
+        add_update(0, freq);
+    }
+
+    double
+    freq_rotator_cc_impl::freq()
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        return d_freq;
+    }
+
+    void
+    freq_rotator_cc_impl::add_update(uint64_t offset, double freq)
+    {
+        freq_update u;
+        u.offset = offset;
+        u.freq = freq;
+        gr::thread::scoped_lock lock(d_mutex);
+        d_pending.push_back(u);
+    }
+
+    void
+    freq_rotator_cc_impl::apply_freq(double freq)
+    {
+        {
+            gr::thread::scoped_lock lock(d_mutex);
+            d_freq = freq;
+        }
+        float w = float(-2.0 * M_PI * freq / d_samp_rate);
+        d_phase_inc = gr_complex(std::cos(w), std::sin(w));
+    }
+
+    int
+    freq_rotator_cc_impl::work(int noutput_items,
+			  gr_vector_const_void_star &input_items,
+			  gr_vector_void_star &output_items)
+    {
+        const uint64_t nir = nitems_read(0);
+
+        {
+            gr::thread::scoped_lock lock(d_mutex);
+            d_updates.insert(d_updates.end(), d_pending.begin(), d_pending.end());
+            d_pending.clear();
+        }
+        std::vector<gr::tag_t> v;
+        get_tags_in_range(v, 0, nir, nir + noutput_items, d_freq_key);
+        for(unsigned int i = 0; i < v.size(); i++){
+            freq_update u;
+            u.offset = v[i].offset;
+            u.freq = pmt::to_double(v[i].value);
+            d_updates.push_back(u);
+        }
+        //updates with equal offsets keep their order, the last one wins
+        std::stable_sort(d_updates.begin(), d_updates.end());
+
+        //rotate in segments of constant frequency
+        unsigned int u = 0;
+        int pos = 0;
+        while(pos < noutput_items){
+            while(u < d_updates.size() && d_updates[u].offset <= nir + pos){
+                apply_freq(d_updates[u].freq);
+                u++;
+            }
+            int end = noutput_items;
+            if(u < d_updates.size() && d_updates[u].offset < nir + noutput_items){
+                end = int(d_updates[u].offset - nir);
+            }
+            rotate(input_items, output_items, pos, end - pos);
+            pos = end;
+        }
+        d_updates.erase(d_updates.begin(), d_updates.begin() + u);
+
+        // Tell runtime system how many output items we produced.
+        return noutput_items;
+    }
+
+    void
+    freq_rotator_cc_impl::rotate(gr_vector_const_void_star &input_items,
+                                 gr_vector_void_star &output_items, int pos, int n)
+    {
+        //all antennas start with the same phase
+        gr_complex phase = d_phase;
+        for(int rx = 0; rx < d_rxant; rx++){
+            const gr_complex* in = (const gr_complex*) input_items[rx];
+            gr_complex* out = (gr_complex*) output_items[rx];
+            phase = d_phase;
+            volk_32fc_s32fc_x2_rotator_32fc(out + pos, in + pos, d_phase_inc, &phase, n);
+        }
+        d_phase = phase / std::abs(phase);
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_FREQ_ROTATOR_CC_IMPL_H
+#define INCLUDED_LTE_FREQ_ROTATOR_CC_IMPL_H
+
+#include <lte/freq_rotator_cc.h>
+#include <gnuradio/thread/thread.h>
+#include <vector>
+
+namespace gr {
+  namespace lte {
+
+    class freq_rotator_cc_impl : public freq_rotator_cc
+    {
+     private:
+      struct freq_update
+      {
+        uint64_t offset;
+        double freq;
+        bool operator<(const freq_update &o) const { return offset < o.offset; }
+      };
+
+      int d_rxant;
+      double d_samp_rate;
+      double d_freq;
+      gr_complex d_phase;
+      gr_complex d_phase_inc;
+
+      pmt::pmt_t d_freq_key;
+      // guards d_pending, updates from messages and the setter applied in
+      // work, and d_freq read by freq()
+      gr::thread::mutex d_mutex;
+      std::vector<freq_update> d_pending;
+      // updates due in this or a later work call, sorted by offset
+      std::vector<freq_update> d_updates;
+
+      void handle_msg_freq(pmt::pmt_t msg);
+      void add_update(uint64_t offset, double freq);
+      void apply_freq(double freq);
+      void rotate(gr_vector_const_void_star &input_items,
+                  gr_vector_void_star &output_items, int pos, int n);
+
+     public:
+      freq_rotator_cc_impl(int rxant, double samp_rate, std::string name);
+      ~freq_rotator_cc_impl();
+
+      void set_freq(double freq);
+      double freq();
+
+      // Where all the action really happens
+      int work(int noutput_items,
+	       gr_vector_const_void_star &input_items,
+	       gr_vector_void_star &output_items);
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_FREQ_ROTATOR_CC_IMPL_H */
+
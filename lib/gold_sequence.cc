@@ -0,0 +1,148 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <lte/gold_sequence.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace gr {
+  namespace lte {
+
+    static const int d_NC = 1600;
+
+    gold_sequence::gold_sequence(uint32_t c_init)
+    {
+      init(c_init);
+    }
+
+    void
+    gold_sequence::init(uint32_t c_init)
+    {
+      // Words hold x(n) ... x(n + 31). Bit 31 follows from the recursions.
+      uint32_t x1 = 1;
+      uint32_t x2 = c_init & 0x7fffffff;
+      x1 |= ((x1 >> 3) ^ x1) << 31;
+      x2 |= ((x2 >> 3) ^ (x2 >> 2) ^ (x2 >> 1) ^ x2) << 31;
+      d_x1 = x1;
+      d_x2 = x2;
+      for(int i = 0; i < d_NC / 32; i++){
+        advance();
+      }
+    }
+
+    // x1(n + 31) = x1(n + 3) + x1(n)
+    // x2(n + 31) = x2(n + 3) + x2(n + 2) + x2(n + 1) + x2(n)
+    // The lower 28 bits of the next word only depend on the current word.
+    // The upper 4 bits additionally depend on the lower bits of the next word.
+    void
+    gold_sequence::advance()
+    {
+      uint32_t t1 = (d_x1 >> 1) ^ (d_x1 >> 4);
+      d_x1 = t1 ^ (t1 << 31) ^ (t1 << 28);
+      uint32_t t2 = (d_x2 >> 1) ^ (d_x2 >> 2) ^ (d_x2 >> 3) ^ (d_x2 >> 4);
+      d_x2 = t2 ^ (t2 << 31) ^ (t2 << 30) ^ (t2 << 29) ^ (t2 << 28);
+    }
+
+    uint32_t
+    gold_sequence::next_word()
+    {
+      uint32_t word = d_x1 ^ d_x2;
+      advance();
+      return word;
+    }
+
+    void
+    gold_sequence::generate_bits(char* out, int len)
+    {
+      for(int i = 0; i < len; i += 32){
+        uint32_t word = next_word();
+        int n = len - i < 32 ? len - i : 32;
+        for(int b = 0; b < n; b++){
+          out[i + b] = char((word >> b) & 1);
+        }
+      }
+    }
+
+    void
+    gold_sequence::generate_nrz(float* out, int len)
+    {
+      int i = 0;
+#ifdef __SSE2__
+      // Flip the sign bit of +1.0 for every set bit, 4 bits at a time.
+      const __m128i mask = _mm_set_epi32(8, 4, 2, 1);
+      const __m128i sign = _mm_set1_epi32(0x80000000);
+      const __m128 one = _mm_set1_ps(1.0f);
+      for(; i + 32 <= len; i += 32){
+        uint32_t word = next_word();
+        for(int b = 0; b < 32; b += 4){
+          __m128i bits = _mm_and_si128(_mm_set1_epi32(word >> b), mask);
+          __m128i flip = _mm_and_si128(_mm_cmpeq_epi32(bits, mask), sign);
+          _mm_storeu_ps(out + i + b,
+                        _mm_xor_ps(one, _mm_castsi128_ps(flip)));
+        }
+      }
+#endif
+      for(; i < len; i += 32){
+        uint32_t word = next_word();
+        int n = len - i < 32 ? len - i : 32;
+        for(int b = 0; b < n; b++){
+          out[i + b] = ((word >> b) & 1) ? -1.0f : 1.0f;
+        }
+      }
+    }
+
+    std::vector<int>
+    gold_sequence::bits(uint32_t c_init, int len)
+    {
+      std::vector<int> seq(len);
+      gold_sequence gold(c_init);
+      for(int i = 0; i < len; i += 32){
+        uint32_t word = gold.next_word();
+        for(int b = 0; b < 32 && i + b < len; b++){
+          seq[i + b] = (word >> b) & 1;
+        }
+      }
+      return seq;
+    }
+
+    std::vector<float>
+    gold_sequence::nrz(uint32_t c_init, int len)
+    {
+      std::vector<float> seq(len);
+      if(len > 0){
+        nrz(&seq[0], len, c_init);
+      }
+      return seq;
+    }
+
+    void
+    gold_sequence::nrz(float* out, int len, uint32_t c_init)
+    {
+      gold_sequence(c_init).generate_nrz(out, len);
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
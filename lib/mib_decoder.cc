@@ -0,0 +1,357 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <lte/mib_decoder.h>
+#include <fftw3.h>
+#include <boost/crc.hpp>
+#include <stdexcept>
+#include <cmath>
+
+namespace gr {
+  namespace lte {
+
+    struct mib_decoder::fft_state : boost::noncopyable
+    {
+      fft_state(int fftl);
+      ~fft_state();
+
+      gr_complex* sym_in;
+      gr_complex* sym_out;
+      fftwf_plan plan;
+    };
+
+    mib_decoder::fft_state::fft_state(int fftl)
+    {
+      sym_in = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * fftl);
+      sym_out = (gr_complex*) fftwf_malloc(sizeof(gr_complex) * fftl);
+      plan = fftwf_plan_dft_1d(fftl, reinterpret_cast<fftwf_complex*>(sym_in),
+                               reinterpret_cast<fftwf_complex*>(sym_out),
+                               FFTW_FORWARD, FFTW_ESTIMATE);
+    }
+
+    mib_decoder::fft_state::~fft_state()
+    {
+      fftwf_destroy_plan(plan);
+      fftwf_free(sym_in);
+      fftwf_free(sym_out);
+    }
+
+    mib_decoder::mib_decoder(int fftl) :
+        d_fftl(fftl),
+        d_cell_id(-1),
+        d_viterbi(d_N_BITS),
+        d_pn_seq(d_N_PARTS * 2 * d_N_PBCH),
+        d_rs_bits(2 * 2 * 110),
+        d_re_pos(d_N_PBCH),
+        d_grid(d_N_SYMS * d_N_SC),
+        d_ce0(d_N_PBCH),
+        d_ce1(d_N_PBCH),
+        d_rx(d_N_PBCH),
+        d_soft(2 * d_N_PBCH),
+        d_cw(d_CW_LEN),
+        d_code(d_CW_LEN),
+        d_bits(d_N_BITS)
+    {
+      if(fftl < 128 || fftl % 128 != 0){
+        throw std::invalid_argument("mib_decoder: fftl must be a multiple of 128");
+      }
+
+      // first sample of slot 1 symbols 0 ... 4 after their CP
+      const int cpl0 = 160 * fftl / 2048;
+      const int cpl = 144 * fftl / 2048;
+      const int slotl = 7 * fftl + cpl0 + 6 * cpl;
+      for(int l = 0; l < d_N_SYMS; l++){
+        d_sym_pos[l] = slotl + cpl0 + l * (fftl + cpl);
+      }
+
+      d_fft = new fft_state(d_fftl);
+
+      // subblock interleaver of 36.212 5.1.4.2.1 for 40 bits as in
+      // subblock_deinterleaver_vfvf: 24 dummy bits lead a 2 x 32 matrix
+      static const int perm[32] = {1,17,9,25,5,21,13,29,3,19,11,27,7,23,15,31,
+                                   0,16,8,24,4,20,12,28,2,18,10,26,6,22,14,30};
+      const int nd = 2 * 32 - d_N_BITS;
+      for(int c = 0; c < 32; c++){
+        for(int r = 0; r < 2; r++){
+          int pos = 32 * r + perm[c] - nd;
+          if(pos >= 0){
+            d_interleaved_pos.push_back(pos);
+          }
+        }
+      }
+    }
+
+    mib_decoder::~mib_decoder()
+    {
+      delete d_fft;
+    }
+
+    bool
+    mib_decoder::decode(mib_info &mib, const std::vector<gr_complex> &frame, int cell_id, float cfo)
+    {
+      if(int(frame.size()) < samples_needed()){
+        return false;
+      }
+      return decode(mib, &frame[0], cell_id, cfo);
+    }
+
+    bool
+    mib_decoder::decode(mib_info &mib, const gr_complex* frame, int cell_id, float cfo)
+    {
+      if(cell_id < 0 || cell_id > 503){
+        return false;
+      }
+      set_cell_id(cell_id);
+
+      // center subcarriers ordered as by extract_subcarriers_vcvc
+      const double w = -2.0 * M_PI * cfo / (15000.0 * d_fftl);
+      const int half = d_N_SC / 2;
+      for(int s = 0; s < d_N_SYMS; s++){
+        const int pos = d_sym_pos[s];
+        for(int i = 0; i < d_fftl; i++){
+          d_fft->sym_in[i] = frame[pos + i] * std::polar(1.0f, float(std::fmod(w * (pos + i), 2.0 * M_PI)));
+        }
+        fftwf_execute(d_fft->plan);
+        gr_complex* grid = &d_grid[s * d_N_SC];
+        for(int k = 0; k < half; k++){
+          grid[k] = d_fft->sym_out[d_fftl - half + k];
+          grid[half + k] = d_fft->sym_out[1 + k];
+        }
+      }
+
+      estimate_channel(d_ce0, 0);
+      estimate_channel(d_ce1, 1);
+      for(int i = 0; i < d_N_PBCH; i++){
+        d_rx[i] = d_grid[d_re_pos[i]];
+      }
+
+      decode_1_ant(&d_soft[0]);
+      if(decode_bch(mib, &d_soft[0]) && mib.N_ant == 1){
+        return true;
+      }
+      decode_2_ant(&d_soft[0]);
+      return decode_bch(mib, &d_soft[0]) && mib.N_ant > 1;
+    }
+
+    void
+    mib_decoder::set_cell_id(int cell_id)
+    {
+      if(cell_id == d_cell_id){
+        return;
+      }
+      d_cell_id = cell_id;
+
+      // PBCH REs as in pbch_decoder_vcvf, slot 1 symbols 0 to 3
+      int idx = 0;
+      for(int c = 0; c < d_N_SC; c++){
+        if(cell_id % 3 != c % 3){
+          d_re_pos[idx] = c;
+          d_re_pos[idx + 48] = c + d_N_SC;
+          idx++;
+        }
+      }
+      for(int c = 0; c < d_N_SC; c++){
+        d_re_pos[96 + c] = c + 2 * d_N_SC;
+        d_re_pos[96 + d_N_SC + c] = c + 3 * d_N_SC;
+      }
+      gold_sequence::nrz(&d_pn_seq[0], d_pn_seq.size(), cell_id);
+
+      // Reference signals of the 6 center RBs as in rs_map_generator_m,
+      // their part of the sequence does not depend on N_rb_dl.
+      const float amp = 1.0f / std::sqrt(2.0f);
+      const int ns = 1;
+      const int m_off = 110 - 6;
+      for(int i = 0; i < 2; i++){
+        const int l = 4 * i;
+        unsigned int c_init = 1024 * (7 * (ns + 1) + l + 1) * (2 * cell_id + 1) + 2 * cell_id + 1;
+        d_gold.init(c_init);
+        d_gold.generate_bits(&d_rs_bits[0], 2 * (m_off + 12));
+        for(int port = 0; port < 2; port++){
+          const int v = (port == 0) == (l == 0) ? 0 : 3;
+          d_rs_off[port][i] = (v + cell_id % 6) % 6;
+          for(int m = 0; m < 12; m++){
+            const int mp = m + m_off;
+            d_rs[port][i][m] = gr_complex(amp * (1 - 2 * d_rs_bits[2 * mp]),
+                                          amp * (1 - 2 * d_rs_bits[2 * mp + 1]));
+          }
+        }
+      }
+    }
+
+    void
+    mib_decoder::estimate_channel(std::vector<gr_complex> &ce, int port)
+    {
+      // linear interpolation between symbols 0 and 4 of the slot
+      gr_complex h0[d_N_SC];
+      gr_complex h4[d_N_SC];
+      interpolate_symbol(h0, port, 0);
+      interpolate_symbol(h4, port, 1);
+      for(int i = 0; i < d_N_PBCH; i++){
+        const int l = d_re_pos[i] / d_N_SC;
+        const int k = d_re_pos[i] % d_N_SC;
+        ce[i] = h0[k] + (h4[k] - h0[k]) * (0.25f * l);
+      }
+    }
+
+    void
+    mib_decoder::interpolate_symbol(gr_complex* h, int port, int rs_sym)
+    {
+      // LS estimates every 6 subcarriers, linear in between, constant at the edges
+      const gr_complex* y = &d_grid[4 * rs_sym * d_N_SC];
+      const int off = d_rs_off[port][rs_sym];
+      gr_complex ls[12];
+      for(int m = 0; m < 12; m++){
+        ls[m] = y[off + 6 * m] * std::conj(d_rs[port][rs_sym][m]);
+      }
+      for(int k = 0; k < d_N_SC; k++){
+        if(k <= off){
+          h[k] = ls[0];
+        }
+        else if(k >= off + 66){
+          h[k] = ls[11];
+        }
+        else{
+          const int m = (k - off) / 6;
+          const float f = ((k - off) % 6) / 6.0f;
+          h[k] = ls[m] * (1.0f - f) + ls[m + 1] * f;
+        }
+      }
+    }
+
+    void
+    mib_decoder::decode_1_ant(float* soft)
+    {
+      const float sqrt2 = std::sqrt(2.0f);
+      for(int n = 0; n < d_N_PBCH; n++){
+        const float mag = std::norm(d_ce0[n]);
+        const gr_complex x = mag > 0.0f ? d_rx[n] * std::conj(d_ce0[n]) * (sqrt2 / mag) : 0.0f;
+        soft[2 * n] = x.real();
+        soft[2 * n + 1] = x.imag();
+      }
+    }
+
+    void
+    mib_decoder::decode_2_ant(float* soft)
+    {
+      // Alamouti combining as in pbch_decoder_vcvf
+      for(int n = 0; n < d_N_PBCH / 2; n++){
+        const gr_complex h0 = (d_ce0[2 * n] + d_ce0[2 * n + 1]) * 0.5f;
+        const gr_complex h1 = (d_ce1[2 * n] + d_ce1[2 * n + 1]) * 0.5f;
+        const gr_complex r0 = d_rx[2 * n];
+        const gr_complex r1 = d_rx[2 * n + 1];
+        gr_complex x0 = r0 * std::conj(h0) + h1 * std::conj(r1);
+        gr_complex x1 = r1 * std::conj(h0) - h1 * std::conj(r0);
+        const float mag = std::norm(h0) + std::norm(h1);
+        const float scale = mag > 0.0f ? 2.0f / mag : 0.0f;
+        x0 *= scale;
+        x1 *= scale;
+        soft[4 * n] = x0.real();
+        soft[4 * n + 1] = x0.imag();
+        soft[4 * n + 2] = x1.real();
+        soft[4 * n + 3] = x1.imag();
+      }
+    }
+
+    bool
+    mib_decoder::decode_bch(mib_info &mib, const float* soft)
+    {
+      // The frame position within 40 ms selects the part of the scrambling sequence.
+      const int part_len = 2 * d_N_PBCH;
+      for(int p = 0; p < d_N_PARTS; p++){
+        const float* seq = &d_pn_seq[p * part_len];
+        // a frame holds 4 copies of the codeword, they are soft combined
+        for(int k = 0; k < d_CW_LEN; k++){
+          float sum = 0.0f;
+          for(int j = 0; j < part_len; j += d_CW_LEN){
+            sum += soft[j + k] * seq[j + k];
+          }
+          d_cw[k] = 0.25f * sum;
+        }
+
+        // the three coded streams are deinterleaved and interleaved bitwise for the decoder
+        for(int s = 0; s < 3; s++){
+          for(int c = 0; c < d_N_BITS; c++){
+            d_code[3 * d_interleaved_pos[c] + s] = d_cw[s * d_N_BITS + c];
+          }
+        }
+        d_viterbi.decode(&d_bits[0], &d_code[0]);
+
+        int N_ant = check_crc();
+        if(N_ant > 0){
+          unpack_mib(mib);
+          mib.N_ant = N_ant;
+          mib.sfn += p;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    int
+    mib_decoder::check_crc()
+    {
+      // CRC as in crc_check_vbvb, the mask signals the number of tx antennas
+      boost::crc_optimal<16, 0x1021, 0x0000, 0x0000, false, false> crc;
+      unsigned char bytes[d_MIB_LEN / 8];
+      for(int i = 0; i < d_MIB_LEN / 8; i++){
+        bytes[i] = 0;
+        for(int b = 0; b < 8; b++){
+          bytes[i] = (bytes[i] << 1) | d_bits[8 * i + b];
+        }
+      }
+      crc.process_bytes(bytes, d_MIB_LEN / 8);
+
+      int rx_check = 0;
+      for(int i = d_MIB_LEN; i < d_N_BITS; i++){
+        rx_check = (rx_check << 1) | d_bits[i];
+      }
+      switch(crc.checksum() ^ rx_check){
+        case 0x0000: return 1;
+        case 0xFFFF: return 2;
+        case 0x5555: return 4;
+        default: return 0;
+      }
+    }
+
+    void
+    mib_decoder::unpack_mib(mib_info &mib)
+    {
+      // 36.331 MasterInformationBlock as in mib_unpack_vbm
+      static const int N_rb_dl[8] = {6, 15, 25, 50, 75, 100, 0, 0};
+      static const float phich_res[4] = {1.0f / 6.0f, 0.5f, 1.0f, 2.0f};
+      const char* bits = &d_bits[0];
+      mib.N_rb_dl = N_rb_dl[4 * bits[0] + 2 * bits[1] + bits[2]];
+      mib.phich_duration = bits[3];
+      mib.phich_resources = phich_res[2 * bits[4] + bits[5]];
+      // 8 MSBs of the SFN, the 2 LSBs are the frame position within 40 ms
+      mib.sfn = 0;
+      for(int i = 0; i < 8; i++){
+        mib.sfn = (mib.sfn << 1) | bits[6 + i];
+      }
+      mib.sfn <<= 2;
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
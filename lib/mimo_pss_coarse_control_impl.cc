@@ -26,26 +26,30 @@
 #include "mimo_pss_coarse_control_impl.h"
 
 #include <cstdio>
+#include <algorithm>
 
 namespace gr {
   namespace lte {
 
     mimo_pss_coarse_control::sptr
-    mimo_pss_coarse_control::make(int rxant)
+    mimo_pss_coarse_control::make(int rxant, int fftl, int reacq_period)
     {
       return gnuradio::get_initial_sptr
-        (new mimo_pss_coarse_control_impl(rxant));
+        (new mimo_pss_coarse_control_impl(rxant, fftl, reacq_period));
     }
 
     /*
      * The private constructor
      */
-    mimo_pss_coarse_control_impl::mimo_pss_coarse_control_impl(int rxant)
+    mimo_pss_coarse_control_impl::mimo_pss_coarse_control_impl(int rxant, int fftl, int reacq_period)
       : gr::block("mimo_pss_coarse_control",
               gr::io_signature::make(1, 8, sizeof(gr_complex)),
               gr::io_signature::make(1, 8, sizeof(gr_complex))),
               d_control(false),
-              d_rxant(rxant)
+              d_reacq(false),
+              d_rxant(rxant),
+              d_halffl(75 * fftl),
+              d_period(std::max(1, reacq_period))
     {
         message_port_register_in(pmt::mp("control"));
         set_msg_handler(pmt::mp("control"), boost::bind(&mimo_pss_coarse_control_impl::handle_msg_control, this, _1));
@@ -57,6 +61,8 @@ namespace gr {
         if(msg == pmt::PMT_T)
         {
             d_control=true;
+            //forwarding again later on means re-acquisition
+            d_reacq=true;
         }
         else{
             d_control=false;
@@ -77,7 +83,10 @@ namespace gr {
 
     {
       const int consume_items = noutput_items;
-      if(!d_control){
+      if(!d_control && d_reacq){
+        noutput_items = forward_reacq(consume_items, input_items, output_items);
+      }
+      else if(!d_control){
         for(int rx = 0; rx < d_rxant; rx++){
           const gr_complex* in = (gr_complex*) input_items[rx];
           gr_complex* out = (gr_complex*) output_items[rx];
@@ -91,6 +100,43 @@ namespace gr {
       return noutput_items;
     }
 
+    int
+    mimo_pss_coarse_control_impl::forward_reacq(int ninput, gr_vector_const_void_star &input_items,
+                                                gr_vector_void_star &output_items)
+    {
+      const long nir = nitems_read(0);
+      const long nw = nitems_written(0);
+      const long period_len = long(d_period) * d_halffl;
+      int produced = 0;
+      int i = 0;
+      while(i < ninput){
+        const long n = nir + i;
+        //samples were dropped, keep output aligned to input modulo half frame
+        const long lag = (n - (nw + produced)) % d_halffl;
+        if(lag != 0){
+          i += (int) std::min(d_halffl - lag, long(ninput - i));
+          continue;
+        }
+
+        //forward the first half frame of each period only
+        const long ppos = n % period_len;
+        if(ppos < d_halffl){
+          const int len = (int) std::min(d_halffl - ppos, long(ninput - i));
+          for(int rx = 0; rx < d_rxant; rx++){
+            const gr_complex* in = (const gr_complex*) input_items[rx];
+            gr_complex* out = (gr_complex*) output_items[rx];
+            memcpy(out + produced, in + i, sizeof(gr_complex) * len);
+          }
+          produced += len;
+          i += len;
+        }
+        else{
+          i += (int) std::min(period_len - ppos, long(ninput - i));
+        }
+      }
+      return produced;
+    }
+
   } /* namespace lte */
 } /* namespace gr */
 
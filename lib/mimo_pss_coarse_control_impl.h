@@ -30,11 +30,16 @@ namespace gr {
     {
      private:
       bool d_control;
+      bool d_reacq;
       int d_rxant;
+      int d_halffl;
+      int d_period;
       void handle_msg_control(pmt::pmt_t msg);
+      int forward_reacq(int ninput, gr_vector_const_void_star &input_items,
+                        gr_vector_void_star &output_items);
 
      public:
-      mimo_pss_coarse_control_impl(int rxant);
+      mimo_pss_coarse_control_impl(int rxant, int fftl, int reacq_period);
       ~mimo_pss_coarse_control_impl();
 
 
@@ -27,40 +27,36 @@
 
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
 #include <volk/volk.h>
 #include "lte/pss.h"
+#include <boost/bind.hpp>
 
 namespace gr {
   namespace lte {
 
     mimo_pss_coarse_sync::sptr
-    mimo_pss_coarse_sync::make(int syncl, int rxant)
+    mimo_pss_coarse_sync::make(int syncl, int rxant, bool fft_corr, int nthreads)
     {
-      return gnuradio::get_initial_sptr(new mimo_pss_coarse_sync_impl(syncl, rxant));
+      return gnuradio::get_initial_sptr(new mimo_pss_coarse_sync_impl(syncl, rxant, fft_corr, nthreads));
     }
 
     /*
      * The private constructor
      */
-    mimo_pss_coarse_sync_impl::mimo_pss_coarse_sync_impl(int syncl, int rxant) :
+    mimo_pss_coarse_sync_impl::mimo_pss_coarse_sync_impl(int syncl, int rxant, bool fft_corr, int nthreads) :
             gr::sync_block("mimo_pss_coarse_sync", gr::io_signature::make(1, 8, sizeof(gr_complex)),
                            gr::io_signature::make(0, 0, 0)), d_syncl(syncl), d_rxant(rxant),
-            d_work_call(0), d_posmax(0), d_max(0)
+            d_work_call(0), d_posmax(0), d_max(0), d_phase(0), d_fft_corr(fft_corr), d_start_time(0),
+            d_lock_time(-1), d_id_result(3 * d_TIME_HYPO), d_kernels(d_N_KERNELS * d_FFT_LEN),
+            d_pool(std::min(nthreads, rxant)), d_task_in(NULL),
+            d_rx_result(rxant * d_N_RESULTS * d_TIME_HYPO)
     {
 
       //make sure that there are enough input items for
       //a 64 point correalation at position 4800 (index=4799)
       set_output_multiple(d_TIME_HYPO + d_CORRL - 1);
 
-      const size_t alig = volk_get_alignment();
-      d_a = (gr_complex*) volk_malloc(sizeof(gr_complex) * 4, alig);
-
-      for(int rx = 0; rx < d_rxant; rx++){
-        gr_complex* p = (gr_complex*) volk_malloc(
-            sizeof(gr_complex) * (d_TIME_HYPO * syncl + d_CORRL - 1), alig);
-        d_buffer.push_back(p);
-      }
-
       // Declare all the message ports.
       d_port_N_id_2 = pmt::string_to_symbol("N_id_2");
       message_port_register_out(d_port_N_id_2);
@@ -68,11 +64,38 @@ namespace gr {
       message_port_register_out(d_port_coarse_pos);
       d_port_control = pmt::string_to_symbol("control");
       message_port_register_out(d_port_control);
+      message_port_register_in(pmt::mp("lock"));
+      set_msg_handler(pmt::mp("lock"), boost::bind(&mimo_pss_coarse_sync_impl::handle_msg_lock, this, _1));
 
       //binary representation of 0.0 is 0
       memset(d_result, 0, sizeof(float) * d_TIME_HYPO);
+      d_id_result.zero();
 
       prepare_corr_vecs();
+
+      for(int w = 0; w < d_pool.nthreads(); w++){
+        boost::shared_ptr<fft_workspace> ws(new fft_workspace);
+        ws->fft_in.resize(d_FFT_LEN);
+        ws->fft_out.resize(d_FFT_LEN);
+        ws->prod.resize(d_N_KERNELS * d_FFT_LEN);
+        ws->corr.resize(d_N_KERNELS * d_FFT_LEN);
+        d_ws.push_back(ws);
+      }
+
+      // Plans are executed on the buffers of each worker with fftwf_execute_dft.
+      int n = d_FFT_LEN;
+      fft_workspace &ws = *d_ws[0];
+      d_plan_f = fftwf_plan_dft_1d(n, reinterpret_cast<fftwf_complex*>(ws.fft_in.data()),
+                                   reinterpret_cast<fftwf_complex*>(ws.fft_out.data()),
+                                   FFTW_FORWARD, FFTW_ESTIMATE);
+      // all kernels of a block are transformed back at once
+      d_plan_r = fftwf_plan_many_dft(1, &n, d_N_KERNELS,
+                                     reinterpret_cast<fftwf_complex*>(ws.prod.data()), NULL, 1, n,
+                                     reinterpret_cast<fftwf_complex*>(ws.corr.data()), NULL, 1, n,
+                                     FFTW_BACKWARD, FFTW_ESTIMATE);
+      prepare_fft_kernels();
+
+      d_corr_job = boost::bind(&mimo_pss_coarse_sync_impl::corr_task, this, _1, _2);
     }
 
     /*
@@ -80,7 +103,8 @@ namespace gr {
      */
     mimo_pss_coarse_sync_impl::~mimo_pss_coarse_sync_impl()
     {
-      volk_free(d_a);
+      fftwf_destroy_plan(d_plan_f);
+      fftwf_destroy_plan(d_plan_r);
     }
 
     int
@@ -91,19 +115,28 @@ namespace gr {
       //deactivate block after synclen ist reached
       if(d_work_call == d_syncl) return noutput_items;
 
-      for(int rx = 0; rx < d_rxant; rx++){
-        memcpy(d_buffer[rx] + d_work_call * d_TIME_HYPO, input_items[rx],
-               sizeof(gr_complex) * (d_TIME_HYPO + d_CORRL - 1));
+      if(d_work_call == 0){
+        d_start_time = gr::high_res_timer_now();
+        //input may have been gated since, publish positions modulo half frame
+        d_phase = nitems_read(0) % d_TIME_HYPO;
       }
 
       //printf("---BEGIN coarse timing---\n");
 
-      for(int d = 0; d < d_TIME_HYPO; d++){
-        for(int rx = 0; rx < d_rxant; rx++){
-          const gr_complex* in = (gr_complex*) input_items[rx];
-          d_result[d] += diff_corr(in + d, d_pss012_t, d_CORRL);
+      d_task_in = &input_items;
+      d_pool.run(d_corr_job, d_rxant);
+      d_task_in = NULL;
+
+      for(int rx = 0; rx < d_rxant; rx++){
+        const float* res = d_rx_result.data() + rx * d_N_RESULTS * d_TIME_HYPO;
+        for(int d = 0; d < d_TIME_HYPO; d++){
+          d_result[d] += res[d];
         }
+        volk_32f_x2_add_32f_a(d_id_result.data(), d_id_result.data(), res + d_TIME_HYPO,
+                              3 * d_TIME_HYPO);
+      }
 
+      for(int d = 0; d < d_TIME_HYPO; d++){
         if(d_result[d] > d_max){
           d_max = d_result[d];
           d_posmax = d;
@@ -119,38 +152,56 @@ namespace gr {
       if(d_work_call != d_syncl) return d_TIME_HYPO;
 
       //obtain N_id_2 after coarse timinig sync
-      d_N_id_2 = calc_N_id_2(d_buffer, d_posmax);
+      d_N_id_2 = calc_N_id_2(d_posmax);
+
+      d_lock_time = 1000.0 * (gr::high_res_timer_now() - d_start_time) / gr::high_res_timer_tps();
 
       //publish results
+      int coarse_pos = (d_posmax + d_phase) % d_TIME_HYPO;
       message_port_pub(d_port_N_id_2, pmt::from_long((long) d_N_id_2));
-      message_port_pub(d_port_coarse_pos, pmt::from_long((long) d_posmax));
+      message_port_pub(d_port_coarse_pos, pmt::from_long((long) coarse_pos));
 
       //stop coarse calculation
       message_port_pub(d_port_control, pmt::PMT_T);
 
       printf("\n%s:found N_id_2=%i\n", name().c_str(), d_N_id_2);
-      printf("%s:coarse pss-pos=%i\n", name().c_str(), d_posmax);
+      printf("%s:coarse pss-pos=%i\n", name().c_str(), coarse_pos);
 
       //Tell runtime system how many output items we produced
       return noutput_items;
     }
 
-    int
-    mimo_pss_coarse_sync_impl::calc_N_id_2(std::vector<gr_complex*> &buffer, int &mpos)
+    void
+    mimo_pss_coarse_sync_impl::handle_msg_lock(pmt::pmt_t msg)
     {
+      //fine sync lost lock after a finished search, search again
+      if(msg == pmt::PMT_F && d_work_call == d_syncl){
+        printf("%s:lock lost, restart coarse timing search\n", name().c_str());
+        restart();
+      }
+    }
 
-      float max0 = 0;
-      float max1 = 0;
-      float max2 = 0;
+    void
+    mimo_pss_coarse_sync_impl::restart()
+    {
+      d_work_call = 0;
+      d_posmax = 0;
+      d_max = 0;
+      d_lock_time = -1;
+      memset(d_result, 0, sizeof(float) * d_TIME_HYPO);
+      d_id_result.zero();
 
-      for(int i = 0; i < d_syncl; i++){
-        for(int rx = 0; rx < d_rxant; rx++){
-          gr_complex* pss = buffer[rx] + mpos + i * d_TIME_HYPO;
-          max0 += diff_corr(pss, d_pss0_t, d_CORRL);
-          max1 += diff_corr(pss, d_pss1_t, d_CORRL);
-          max2 += diff_corr(pss, d_pss2_t, d_CORRL);
-        }
-      }
+      //resume sample forwarding in coarse control
+      message_port_pub(d_port_control, pmt::PMT_F);
+    }
+
+    int
+    mimo_pss_coarse_sync_impl::calc_N_id_2(int mpos)
+    {
+      // sums over all sync loops and antennas at the final timing
+      float max0 = d_id_result[mpos];
+      float max1 = d_id_result[d_TIME_HYPO + mpos];
+      float max2 = d_id_result[2 * d_TIME_HYPO + mpos];
 
       printf("Nid2 correlation values: id0:%f\tid1:%f\tid2:%f\t\n", max0, max1, max2);
 
@@ -175,23 +226,115 @@ namespace gr {
       pss::gen_conj_pss_t(d_pss0_t, 0, d_CORRL);
       pss::gen_conj_pss_t(d_pss1_t, 1, d_CORRL);
       pss::gen_conj_pss_t(d_pss2_t, 2, d_CORRL);
+    }
 
-      //add pss for correlation
-      for(int i = 0; i < d_CORRL; i++){
-        d_pss012_t[i] = d_pss0_t[i] + d_pss1_t[i] + d_pss2_t[i];
+    void
+    mimo_pss_coarse_sync_impl::prepare_fft_kernels()
+    {
+      // Part i of PSS s is zero padded to d_CORRL, time reversed and
+      // transformed. A product with an input spectrum then yields the dot
+      // products of this part for d_FFT_VALID hypotheses. 1/N of the
+      // backward transform is included.
+      gr_complex* pss[3] = { d_pss0_t, d_pss1_t, d_pss2_t };
+      int len4 = d_CORRL / 4;
+      float scale = 1.0f / d_FFT_LEN;
+      fft_workspace &ws = *d_ws[0];
+      for(int s = 0; s < 3; s++){
+        for(int i = 0; i < 4; i++){
+          ws.fft_in.zero();
+          for(int k = i * len4; k < (i + 1) * len4; k++){
+            ws.fft_in[(d_FFT_LEN - k) % d_FFT_LEN] = pss[s][k] * scale;
+          }
+          fftwf_execute(d_plan_f);
+          memcpy(d_kernels.data() + (s * 4 + i) * d_FFT_LEN, ws.fft_out.data(),
+                 sizeof(gr_complex) * d_FFT_LEN);
+        }
       }
+    }
 
+    void
+    mimo_pss_coarse_sync_impl::corr_task(int rx, int worker)
+    {
+      const gr_complex* in = (const gr_complex*) (*d_task_in)[rx];
+      float* res = d_rx_result.data() + rx * d_N_RESULTS * d_TIME_HYPO;
+      if(d_fft_corr){
+        fft_corr(in, res, *d_ws[worker]);
+      }
+      else{
+        direct_corr(in, res);
+      }
     }
 
-//calculate differential correlation, 4parts, returns absolute value
-    float
-    mimo_pss_coarse_sync_impl::diff_corr(const gr_complex* x, const gr_complex* y, int len)
+    // Differential correlation of all d_TIME_HYPO hypotheses with the PSS
+    // sum, followed by one row for each N_id_2.
+    void
+    mimo_pss_coarse_sync_impl::direct_corr(const gr_complex* in, float* result)
+    {
+      const gr_complex* pss[3] = { d_pss0_t, d_pss1_t, d_pss2_t };
+      int len4 = d_CORRL / 4;
+      for(int d = 0; d < d_TIME_HYPO; d++){
+        gr_complex a[3][4];
+        gr_complex a012[4];
+        for(int i = 0; i < 4; i++){
+          for(int s = 0; s < 3; s++){
+            volk_32fc_x2_dot_prod_32fc(&a[s][i], in + d + len4 * i, pss[s] + len4 * i, len4);
+          }
+          a012[i] = a[0][i] + a[1][i] + a[2][i];
+        }
+        result[d] = diff_combine(a012);
+        for(int s = 0; s < 3; s++){
+          result[(s + 1) * d_TIME_HYPO + d] = diff_combine(a[s]);
+        }
+      }
+    }
+
+    // Same as direct_corr, by overlap-save FFT correlation.
+    void
+    mimo_pss_coarse_sync_impl::fft_corr(const gr_complex* in, float* result, fft_workspace &ws)
     {
-      int len4 = len / 4;
-      for(int i = 0; i < 4; i++){
-        volk_32fc_x2_dot_prod_32fc(d_a + i, x + len4 * i, y + len4 * i, len4);
+      const int avail = d_TIME_HYPO + d_CORRL - 1;
+      for(int base = 0; base < d_TIME_HYPO; base += d_FFT_VALID){
+        int n_in = std::min(int(d_FFT_LEN), avail - base);
+        memcpy(ws.fft_in.data(), in + base, sizeof(gr_complex) * n_in);
+        std::fill(ws.fft_in.data() + n_in, ws.fft_in.data() + d_FFT_LEN, gr_complex(0.0f, 0.0f));
+        fftwf_execute_dft(d_plan_f, reinterpret_cast<fftwf_complex*>(ws.fft_in.data()),
+                          reinterpret_cast<fftwf_complex*>(ws.fft_out.data()));
+
+        for(int k = 0; k < d_N_KERNELS; k++){
+          volk_32fc_x2_multiply_32fc_a(ws.prod.data() + k * d_FFT_LEN, ws.fft_out.data(),
+                                       d_kernels.data() + k * d_FFT_LEN, d_FFT_LEN);
+        }
+        fftwf_execute_dft(d_plan_r, reinterpret_cast<fftwf_complex*>(ws.prod.data()),
+                          reinterpret_cast<fftwf_complex*>(ws.corr.data()));
+
+        // PSS sum is linear, thus parts of all N_id_2 are added.
+        int n_out = std::min(int(d_FFT_VALID), d_TIME_HYPO - base);
+        const gr_complex* c0 = ws.corr.data();
+        const gr_complex* c1 = c0 + 4 * d_FFT_LEN;
+        const gr_complex* c2 = c1 + 4 * d_FFT_LEN;
+        for(int n = 0; n < n_out; n++){
+          gr_complex a[3][4];
+          gr_complex a012[4];
+          for(int i = 0; i < 4; i++){
+            int idx = i * d_FFT_LEN + n;
+            a[0][i] = c0[idx];
+            a[1][i] = c1[idx];
+            a[2][i] = c2[idx];
+            a012[i] = c0[idx] + c1[idx] + c2[idx];
+          }
+          result[base + n] = diff_combine(a012);
+          for(int s = 0; s < 3; s++){
+            result[(s + 1) * d_TIME_HYPO + base + n] = diff_combine(a[s]);
+          }
+        }
       }
-      return abs(d_a[0] * conj(d_a[1]) + d_a[1] * conj(d_a[2]) + d_a[2] * conj(d_a[3]));
+    }
+
+//combine the 4 partial correlations differentially, returns absolute value
+    float
+    mimo_pss_coarse_sync_impl::diff_combine(const gr_complex* a)
+    {
+      return abs(a[0] * conj(a[1]) + a[1] * conj(a[2]) + a[2] * conj(a[3]));
     }
 
   } /* namespace lte */
@@ -23,6 +23,11 @@
 
 #include <lte/mimo_pss_coarse_sync.h>
 #include <gnuradio/filter/fir_filter.h>
+#include <gnuradio/high_res_timer.h>
+#include <fftw3.h>
+#include "aligned_buffer.h"
+#include "antenna_pool.h"
+#include <boost/shared_ptr.hpp>
 
 namespace gr
 {
@@ -34,6 +39,13 @@ class mimo_pss_coarse_sync_impl : public mimo_pss_coarse_sync
 private:
     static const int d_CORRL=64;
     static const int d_TIME_HYPO=d_CORRL*75;
+    // overlap-save FFT correlation: each block yields d_FFT_LEN-d_CORRL+1 hypotheses
+    static const int d_FFT_LEN=1024;
+    static const int d_FFT_VALID=d_FFT_LEN-d_CORRL+1;
+    // 4 parts of the differential correlation for each N_id_2
+    static const int d_N_KERNELS=3*4;
+    // correlation with the PSS sum and with each N_id_2
+    static const int d_N_RESULTS=4;
 
 
     int d_syncl;
@@ -42,11 +54,14 @@ private:
     int d_work_call;
     int d_posmax;
     float d_max;
+    // position of the first correlation window modulo d_TIME_HYPO
+    int d_phase;
+    bool d_fft_corr;
+    gr::high_res_timer_type d_start_time;
+    double d_lock_time;
 
     //filter::kernel::fir_filter_ccf *d_fir;
 
-    std::vector< gr_complex* > d_buffer;
-
     pmt::pmt_t d_port_coarse_pos;
     pmt::pmt_t d_port_N_id_2;
     pmt::pmt_t d_port_control;
@@ -54,20 +69,52 @@ private:
     gr_complex d_pss0_t[d_CORRL];
     gr_complex d_pss1_t[d_CORRL];
     gr_complex d_pss2_t[d_CORRL];
-    gr_complex d_pss012_t[d_CORRL];
-    gr_complex* d_a;
     float d_result[d_TIME_HYPO];
+    // Running sums for each N_id_2 and timing hypothesis, one row per N_id_2.
+    // The N_id_2 decision at the final timing needs no sample history.
+    aligned_buffer<float> d_id_result;
 
     void prepare_corr_vecs();
-
-    int calc_N_id_2(std::vector< gr_complex* > &buffer, int &mpos);
-    float diff_corr(const gr_complex* x, const gr_complex* y, int len);
+    void prepare_fft_kernels();
+
+    // Spectra of the zero padded PSS parts, one row of d_FFT_LEN per kernel
+    aligned_buffer<gr_complex> d_kernels;
+    // FFT buffers, one set per worker thread
+    struct fft_workspace : boost::noncopyable
+    {
+      aligned_buffer<gr_complex> fft_in;
+      aligned_buffer<gr_complex> fft_out;
+      aligned_buffer<gr_complex> prod;
+      aligned_buffer<gr_complex> corr;
+    };
+    std::vector<boost::shared_ptr<fft_workspace> > d_ws;
+    fftwf_plan d_plan_f;
+    fftwf_plan d_plan_r;
+
+    void fft_corr(const gr_complex* in, float* result, fft_workspace &ws);
+    void direct_corr(const gr_complex* in, float* result);
+
+    // Correlation results of one work call, d_N_RESULTS rows per antenna.
+    // Rows are added in antenna order to keep results independent of threading.
+    antenna_pool d_pool;
+    antenna_pool::job_t d_corr_job;
+    const gr_vector_const_void_star* d_task_in;
+    aligned_buffer<float> d_rx_result;
+    void corr_task(int rx, int worker);
+
+    int calc_N_id_2(int mpos);
+    static float diff_combine(const gr_complex* a);
+
+    void handle_msg_lock(pmt::pmt_t msg);
+    void restart();
 
 
 public:
-    mimo_pss_coarse_sync_impl(int syncl, int rxant);
+    mimo_pss_coarse_sync_impl(int syncl, int rxant, bool fft_corr, int nthreads);
     ~mimo_pss_coarse_sync_impl();
 
+    double time_to_lock(){ return d_lock_time; }
+
     // Where all the action really happens
     int work(int noutput_items,
              gr_vector_const_void_star &input_items,
@@ -29,6 +29,8 @@
 #include <cmath>
 #include <volk/volk.h>
 #include "lte/pss.h"
+#include <algorithm>
+#include <boost/bind.hpp>
 
 #include <gnuradio/filter/fir_filter.h>
 
@@ -38,16 +40,16 @@ namespace lte
 {
 
 mimo_pss_fine_sync::sptr
-mimo_pss_fine_sync::make(int fftl, int rxant, int grpdelay)
+mimo_pss_fine_sync::make(int fftl, int rxant, int grpdelay, int nthreads)
 {
     return gnuradio::get_initial_sptr
-           (new mimo_pss_fine_sync_impl(fftl, rxant, grpdelay));
+           (new mimo_pss_fine_sync_impl(fftl, rxant, grpdelay, nthreads));
 }
 
 /*
  * The private constructor
  */
-mimo_pss_fine_sync_impl::mimo_pss_fine_sync_impl(int fftl, int rxant, int grpdelay)
+mimo_pss_fine_sync_impl::mimo_pss_fine_sync_impl(int fftl, int rxant, int grpdelay, int nthreads)
     : gr::sync_block("mimo_pss_fine_sync",
                      gr::io_signature::make(1, 8, sizeof(gr_complex)),
                      gr::io_signature::make(0, 0, 0)),
@@ -65,11 +67,19 @@ mimo_pss_fine_sync_impl::mimo_pss_fine_sync_impl(int fftl, int rxant, int grpdel
     d_half_frame_start(0),
     d_corr_val(0),
     d_is_locked(false),
+    d_quality(0),
+    d_quality_ref(-1),
+    d_noise_floor(16.0f/fftl),
+    d_misses(0),
+    d_last_half_frame(-1),
     d_decim(fftl/64),
     d_step(0),
     d_val_early(0),
     d_val_prompt(0),
-    d_val_late(0)
+    d_val_late(0),
+    d_pool(std::min(nthreads, rxant)),
+    d_task_in(NULL),
+    d_rx_vals(rxant)
 {
 
     d_slot_key=pmt::string_to_symbol("slot");
@@ -79,7 +89,7 @@ mimo_pss_fine_sync_impl::mimo_pss_fine_sync_impl(int fftl, int rxant, int grpdel
     size_t alig = volk_get_alignment();
     d_pssX_t = (gr_complex*) volk_malloc(sizeof(gr_complex)*d_fftl, alig);
 
-    d_a = (gr_complex*)volk_malloc(sizeof(gr_complex)*4,alig);
+    d_corr_job = boost::bind(&mimo_pss_fine_sync_impl::corr_task, this, _1, _2);
 
     message_port_register_in(pmt::mp("N_id_2"));
     set_msg_handler(pmt::mp("N_id_2"), boost::bind(&mimo_pss_fine_sync_impl::handle_msg_N_id_2, this, _1));
@@ -90,6 +100,8 @@ mimo_pss_fine_sync_impl::mimo_pss_fine_sync_impl(int fftl, int rxant, int grpdel
     message_port_register_out(d_port_half_frame);
     d_port_lock= pmt::string_to_symbol("lock");
     message_port_register_out(d_port_lock);
+    d_port_frac_timing= pmt::string_to_symbol("frac_timing");
+    message_port_register_out(d_port_frac_timing);
 
 
 //    std::vector< float > taps (5,6 );
@@ -103,7 +115,6 @@ mimo_pss_fine_sync_impl::mimo_pss_fine_sync_impl(int fftl, int rxant, int grpdel
 mimo_pss_fine_sync_impl::~mimo_pss_fine_sync_impl()
 {
     volk_free(d_pssX_t);
-    volk_free(d_a);
 
 }
 
@@ -116,6 +127,13 @@ mimo_pss_fine_sync_impl::handle_msg_N_id_2(pmt::pmt_t msg)
     pss::gen_conj_pss_t(d_pssX_t, d_N_id_2, d_fftl);
     //volk_32fc_conjugate_32fc(d_pssX_t, d_pssX_t, d_fftl);
 
+    int len4=d_fftl/4;
+    for(int i=0; i<4; i++){
+        gr_complex e;
+        volk_32fc_x2_conjugate_dot_prod_32fc(&e, d_pssX_t+len4*i, d_pssX_t+len4*i, len4);
+        d_pss_norm[i]=std::sqrt(e.real());
+    }
+
 }
 
 
@@ -128,6 +146,12 @@ mimo_pss_fine_sync_impl::handle_msg_coarse_pos(pmt::pmt_t msg)
     d_coarse_pos = d_coarse_pos*d_decim-d_grpdelay;
     d_is_locked=false;
     d_fine_corr_count=0;
+    //forget old timing, this may be a re-acquisition
+    d_corr_val=0;
+    d_step=0;
+    d_quality_ref=-1;
+    d_misses=0;
+    d_last_half_frame=-1;
 }
 
 
@@ -169,14 +193,19 @@ mimo_pss_fine_sync_impl::work(int noutput_items,
 
     //printf("NIR:%li, NOUT: %i\n", nir, noutput_items);
 
-    for(int i=0; i<noutput_items; i++)
+    if(!d_is_locked)
     {
-        mod_pos=(nir+i)%d_halffl;
-        if(!d_is_locked)
-        {
-            //do first fine sync
+        //do first fine sync
 
-            int search_int=d_decim*2; //search intervall for correlation maximum
+        int search_int=d_decim*2; //search intervall for correlation maximum
+        bool search_done=false;
+
+        //collect positions within the search intervall, correlations are
+        //calculated for all of them at once
+        d_cpos.clear();
+        for(int i=0; i<noutput_items; i++)
+        {
+            mod_pos=(nir+i)%d_halffl;
 
             //position of pss is saved as modulo value
             //-->search intervall can be within 2 following half frame lengths (rare case)
@@ -187,35 +216,55 @@ mimo_pss_fine_sync_impl::work(int noutput_items,
             if(diff<search_int)     //if in search intervall
             {
                 d_fine_corr_count++;
-                val=diff_corr2(input_items, d_pssX_t, d_fftl, i);
-                if(val>d_corr_val)
-                {
-                    d_fine_pos=mod_pos;
-                    d_half_frame_start=calc_half_frame_start(mod_pos);
-                    d_corr_val=val;
-                    //printf("new fine timing: corr_val:%f\t half_frame_start: %li \t nitems_read: %li\n", d_corr_val, d_half_frame_start, nir);
-                }
+                d_cpos.push_back(i);
             }
             if(d_fine_corr_count==2*search_int-1)    //reached end of search intervall;
             {
-                d_is_locked=true;
-                message_port_pub(d_port_lock, pmt::PMT_T);
-                message_port_pub(d_port_half_frame, pmt::from_long((long)d_half_frame_start));
-                printf("fine timing is locked to mod pss_pos:%i\n now tracking\n", d_fine_pos);
+                search_done=true;
                 break;
             }
         }
-        //do tracking after block is locked, 3 correlations around center
-        else
+
+        diff_corr2(input_items);
+        for(unsigned int k=0; k<d_cpos.size(); k++)
         {
+            if(d_vals[k]>d_corr_val)
+            {
+                mod_pos=(nir+d_cpos[k])%d_halffl;
+                d_fine_pos=mod_pos;
+                d_half_frame_start=calc_half_frame_start(mod_pos);
+                d_corr_val=d_vals[k];
+                //printf("new fine timing: corr_val:%f\t half_frame_start: %li \t nitems_read: %li\n", d_corr_val, d_half_frame_start, nir);
+            }
+        }
+
+        if(search_done)
+        {
+            d_is_locked=true;
+            message_port_pub(d_port_lock, pmt::PMT_T);
+            publish_half_frame();
+            printf("fine timing is locked to mod pss_pos:%i\n now tracking\n", d_fine_pos);
+        }
+    }
+    //do tracking after block is locked, 3 correlations around center
+    else
+    {
+        for(int i=0; i<noutput_items; i++)
+        {
+            mod_pos=(nir+i)%d_halffl;
             if((d_fine_pos-1+d_halffl)%d_halffl==mod_pos)
             {
                 int fine_pos;
 
                 d_corr_val   = d_corr_val*0.80;
-                d_val_early  = diff_corr2(input_items, d_pssX_t, d_fftl, i);
-                d_val_prompt = diff_corr2(input_items, d_pssX_t, d_fftl, i+1);
-                d_val_late   = diff_corr2(input_items, d_pssX_t, d_fftl, i+2);
+                d_cpos.clear();
+                d_cpos.push_back(i);
+                d_cpos.push_back(i+1);
+                d_cpos.push_back(i+2);
+                diff_corr2(input_items);
+                d_val_early  = d_vals[0];
+                d_val_prompt = d_vals[1];
+                d_val_late   = d_vals[2];
 
                 val=d_corr_val;
                 fine_pos=d_fine_pos;
@@ -238,10 +287,27 @@ mimo_pss_fine_sync_impl::work(int noutput_items,
 
                 //printf("PSS-tracking: old_pos:%i\told_val:%f\tnew_pos:%i\tnew_val:%f\n", d_fine_pos, d_corr_val, fine_pos, val);
 
+                int k=fine_pos-d_fine_pos+1;
+                if(!update_lock(calc_quality(input_items, d_cpos[k], d_vals[k])))
+                {
+                    //wait for a new coarse position
+                    d_is_locked=false;
+                    d_coarse_pos=-1;
+                    d_step=0;
+                    message_port_pub(d_port_lock, pmt::PMT_F);
+                    printf("fine timing lost lock, quality:%f\n", d_quality);
+                    break;
+                }
+
+                //sub-sample peak position relative to the new integer position
+                float frac=d_fine_pos-fine_pos+calc_peak_offset(d_val_early, d_val_prompt, d_val_late);
+
                 d_fine_pos=(fine_pos+d_halffl)%d_halffl;
                 d_corr_val=val;
                 d_half_frame_start=calc_half_frame_start(fine_pos);
-                message_port_pub(d_port_half_frame, pmt::from_long((long)d_half_frame_start));
+                publish_half_frame();
+                double frac_start=fmod(d_half_frame_start+frac+d_halffl, (double)d_halffl);
+                message_port_pub(d_port_frac_timing, pmt::from_double(frac_start));
                 //step over several samples until next pss occurs
                 d_step=d_halffl-noutput_items;
                 break;
@@ -261,25 +327,112 @@ mimo_pss_fine_sync_impl::calc_half_frame_start(int pss_pos)
 }
 
 
-//differential correlation for n streams
+//offset of the correlation peak from the prompt position, vertex of the
+//parabola through early, prompt and late, limited to +-1 sample
 float
-mimo_pss_fine_sync_impl::diff_corr2(const gr_vector_const_void_star in, const gr_complex* y, int len, int cpos)
+mimo_pss_fine_sync_impl::calc_peak_offset(float early, float prompt, float late)
 {
-    float val=0;
+    float den=early-2*prompt+late;
+    if(den>=0)
+        return 0;
+    float offset=0.5f*(early-late)/den;
+    return std::max(-1.0f, std::min(1.0f, offset));
+}
+
+
+//publish half frame start if it changed since the last time
+void
+mimo_pss_fine_sync_impl::publish_half_frame()
+{
+    if(d_half_frame_start==d_last_half_frame)
+        return;
+    d_last_half_frame=d_half_frame_start;
+    message_port_pub(d_port_half_frame, pmt::from_long(d_half_frame_start));
+}
+
+
+//correlation at pos divided by its Cauchy-Schwarz bound, sum over all antennas
+float
+mimo_pss_fine_sync_impl::calc_quality(const gr_vector_const_void_star &in, int pos, float corr)
+{
+    int len4=d_fftl/4;
+    float norm=0;
+    for(int rx=0; rx<d_rxant; rx++)
+    {
+        const gr_complex* x=(const gr_complex*) in[rx]+pos;
+        float xn[4];
+        for(int i=0; i<4; i++)
+        {
+            gr_complex e;
+            volk_32fc_x2_conjugate_dot_prod_32fc(&e, x+len4*i, x+len4*i, len4);
+            xn[i]=std::sqrt(e.real());
+        }
+        for(int i=0; i<3; i++)
+            norm+=xn[i]*xn[i+1]*d_pss_norm[i]*d_pss_norm[i+1];
+    }
+    return norm>0 ? corr/norm : 0;
+}
+
+
+//update lock state with the quality of one half frame, returns false if lock is lost
+bool
+mimo_pss_fine_sync_impl::update_lock(float quality)
+{
+    d_quality=quality;
+    if(d_quality_ref<0)
+        d_quality_ref=quality;
+
+    float thr=std::max(d_noise_floor, 0.25f*d_quality_ref);
+    if(quality<thr)
+    {
+        return ++d_misses<d_MAX_MISSES;
+    }
+
+    d_misses=0;
+    d_quality_ref=0.9f*d_quality_ref+0.1f*quality;
+    return true;
+}
+
+
+//differential correlation for n streams at all positions in d_cpos, results go to d_vals
+void
+mimo_pss_fine_sync_impl::diff_corr2(const gr_vector_const_void_star &in)
+{
+    d_vals.assign(d_cpos.size(), 0.0f);
+    if(d_cpos.empty())
+        return;
+
+    d_task_in=&in;
+    d_pool.run(d_corr_job, d_rxant);
+    d_task_in=NULL;
+
+    //add antennas in order, results do not depend on the number of threads
     for(int rx=0; rx<d_rxant; rx++)
-        val+=diff_corr((gr_complex*) in[rx]+cpos, y, len);
-    return val;
+        for(unsigned int k=0; k<d_cpos.size(); k++)
+            d_vals[k]+=d_rx_vals[rx][k];
+}
+
+void
+mimo_pss_fine_sync_impl::corr_task(int rx, int worker)
+{
+    const gr_complex* in=(const gr_complex*) (*d_task_in)[rx];
+    std::vector<float> &vals=d_rx_vals[rx];
+    vals.resize(d_cpos.size());
+    for(unsigned int k=0; k<d_cpos.size(); k++)
+        vals[k]=diff_corr(in+d_cpos[k], d_pssX_t, d_fftl);
 }
 
 //calculate differential correlation, 4parts, returns absolute value
 float
 mimo_pss_fine_sync_impl::diff_corr(const gr_complex* x,const gr_complex* y, int len)
 {
+    //called from several worker threads, thus no member scratch
+    gr_complex a[4];
     int len4 = len/4;
     for(int i=0; i<4; i++){
-        volk_32fc_x2_dot_prod_32fc(d_a+i, x+len4*i, y+len4*i, len4);
+        volk_32fc_x2_dot_prod_32fc(a+i, x+len4*i, y+len4*i, len4);
     }
-    return abs(d_a[0]*conj(d_a[1]) + d_a[1]*conj(d_a[2]) + d_a[2]*conj(d_a[3]));
+    return abs(a[0]*conj(a[1]) + a[1]*conj(a[2]) + a[2]*conj(a[3]));
 }
 
 
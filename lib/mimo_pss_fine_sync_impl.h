@@ -23,6 +23,8 @@
 #define INCLUDED_LTE_MIMO_PSS_FINE_SYNC_IMPL_H
 
 #include <lte/mimo_pss_fine_sync.h>
+#include "antenna_pool.h"
+#include <vector>
 
 
 namespace gr
@@ -33,6 +35,9 @@ namespace lte
 class mimo_pss_fine_sync_impl : public mimo_pss_fine_sync
 {
 private:
+    // consecutive bad half frames until lock is lost
+    static const int d_MAX_MISSES = 4;
+
     int d_fftl;
     int d_rxant;
     int d_grpdelay;
@@ -54,27 +59,50 @@ private:
     float d_val_late;
     bool d_is_locked;
 
+    // lock quality, its running average and lower bound for noise only input
+    float d_quality;
+    float d_quality_ref;
+    float d_noise_floor;
+    int d_misses;
+    long d_last_half_frame;
+
     pmt::pmt_t d_slot_key;
     pmt::pmt_t d_id_key;
     pmt::pmt_t d_tag_id;
 
     pmt::pmt_t d_port_half_frame;
     pmt::pmt_t d_port_lock;
+    pmt::pmt_t d_port_frac_timing;
 
     gr_complex* d_pssX_t;
-    gr_complex* d_a;
+    float d_pss_norm[4];
+
+    // Correlations at d_cpos for each antenna, one row per antenna.
+    antenna_pool d_pool;
+    antenna_pool::job_t d_corr_job;
+    const gr_vector_const_void_star* d_task_in;
+    std::vector<int> d_cpos;
+    std::vector<float> d_vals;
+    std::vector<std::vector<float> > d_rx_vals;
+    void corr_task(int rx, int worker);
 
     float diff_corr(const gr_complex* x,const gr_complex* y, int len);
-    float diff_corr2(const gr_vector_const_void_star in, const gr_complex* y, int len, int cpos);
+    void diff_corr2(const gr_vector_const_void_star &in);
     int calc_half_frame_start(int pss_pos);
+    static float calc_peak_offset(float early, float prompt, float late);
+    float calc_quality(const gr_vector_const_void_star &in, int pos, float corr);
+    bool update_lock(float quality);
+    void publish_half_frame();
 
     void handle_msg_N_id_2(pmt::pmt_t msg);
     void handle_msg_coarse_pos(pmt::pmt_t msg);
 
 public:
-    mimo_pss_fine_sync_impl(int fftl, int rxant, int grpdelay);
+    mimo_pss_fine_sync_impl(int fftl, int rxant, int grpdelay, int nthreads);
     ~mimo_pss_fine_sync_impl();
 
+    float lock_quality(){ return d_quality; }
+
     void forecast (int noutput_items, gr_vector_int &ninput_items_required);
     // Where all the action really happens
     int work(int noutput_items,
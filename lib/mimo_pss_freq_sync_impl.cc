@@ -67,10 +67,21 @@ mimo_pss_freq_sync_impl::mimo_pss_freq_sync_impl(int fftl, int rxant, boost::sha
     for(int i=0; i<d_rxant; i++)
         d_buf_pss[i] = (gr_complex*) volk_malloc(sizeof(gr_complex)*d_fftl, alig);
 
+    //PSS subcarriers -31 ... -1 and 1 ... 31
+    for(int c=0; c<62; c++)
+        d_pss_bin[c] = c<31 ? c-31 : c-30;
+
+    //executed on the buffer of each antenna with fftwf_execute_dft
+    d_fft_out = (gr_complex*)volk_malloc(sizeof(gr_complex)*d_fftl, alig);
+    d_plan = fftwf_plan_dft_1d(d_fftl, reinterpret_cast<fftwf_complex*>(d_buf_pss[0]), reinterpret_cast<fftwf_complex*>(d_fft_out), FFTW_FORWARD, FFTW_ESTIMATE);
+
     //set_max_noutput_items(fftl*75);   work call for maximum one pss
 
     d_id_key = pmt::string_to_symbol("N_id_2");
 
+    d_port_freq = pmt::string_to_symbol("freq");
+    message_port_register_out(d_port_freq);
+
 }
 
 /*
@@ -78,6 +89,8 @@ mimo_pss_freq_sync_impl::mimo_pss_freq_sync_impl(int fftl, int rxant, boost::sha
  */
 mimo_pss_freq_sync_impl::~mimo_pss_freq_sync_impl()
 {
+    fftwf_destroy_plan(d_plan);
+    volk_free(d_fft_out);
 
     for(int i=0; i<d_rxant; i++)
         volk_free(d_buf_pss[i]);
@@ -111,6 +124,8 @@ mimo_pss_freq_sync_impl::work(int noutput_items,
             //printf("%s\tASYNC!\tnew Nid2 = %i\t\n", name().c_str(), d_N_id_2);
             d_N_id_2 = n_id_2;
             pss::gen_conj_pss_t(d_pssX, d_N_id_2, d_fftl);
+            pss::zc(d_pss_f, d_N_id_2);
+            volk_32fc_conjugate_32fc(d_pss_f, d_pss_f, 62);
         }
     }
 
@@ -166,6 +181,16 @@ mimo_pss_freq_sync_impl::mult_memcpy(gr_complex** &out,
 void
 mimo_pss_freq_sync_impl::calc_freq_off()
 {
+    //the fractional estimate is meaningless while the PSS is off by whole subcarriers
+    int int_off = calc_int_freq_off();
+    if(int_off != 0)
+    {
+        //printf("FREQ SYNC: integer offset of %i subcarriers\n", int_off);
+        d_f_count = 0;
+        set_freq_est(d_f_est + 15000.0 * int_off);
+        return;
+    }
+
     gr_complex psscorr_a;
     gr_complex psscorr_b;
     gr_complex psscorr;
@@ -197,12 +222,53 @@ mimo_pss_freq_sync_impl::calc_freq_off()
     float a=0.8/d_f_count;
     a=a<0.01 ? 0.01 : a;
 
-    d_f_est = d_f_est + (a * freq);
-
-    (*d_sig).set_frequency((-1)*double(d_f_est) );
+    set_freq_est(d_f_est + (a * freq));
     //printf("FREQ SYNC: estimate=%f, new freq-compensate: %f\n", freq, d_f_est);
 }
 
+//integer frequency offset in subcarriers.
+//PSS subcarriers of one FFT per antenna are correlated with the PSS shifted by each candidate offset.
+int
+mimo_pss_freq_sync_impl::calc_int_freq_off()
+{
+    float metric[2*d_MAX_INT_OFF+1] = {0};
+
+    for(int i=0; i<d_rxant; i++)
+    {
+        fftwf_execute_dft(d_plan, reinterpret_cast<fftwf_complex*>(d_buf_pss[i]), reinterpret_cast<fftwf_complex*>(d_fft_out));
+        for(int k=-d_MAX_INT_OFF; k<=d_MAX_INT_OFF; k++)
+        {
+            gr_complex val = 0;
+            for(int c=0; c<62; c++)
+                val += d_fft_out[(d_pss_bin[c]+k+d_fftl)%d_fftl] * d_pss_f[c];
+            metric[k+d_MAX_INT_OFF] += norm(val);
+        }
+    }
+
+    int kmax=0;
+    for(int k=-d_MAX_INT_OFF; k<=d_MAX_INT_OFF; k++)
+    {
+        if(metric[k+d_MAX_INT_OFF] > metric[kmax+d_MAX_INT_OFF])
+            kmax=k;
+    }
+
+    //offsets of about half a subcarrier leak into both neighbours, leave them to the fractional estimate
+    if(metric[kmax+d_MAX_INT_OFF] < 2.0*metric[d_MAX_INT_OFF])
+        return 0;
+    return kmax;
+}
+
+void
+mimo_pss_freq_sync_impl::set_freq_est(float f_est)
+{
+    d_f_est = f_est;
+
+    //offset to remove, for freq_rotator_cc
+    message_port_pub(d_port_freq, pmt::from_double(d_f_est));
+    if(d_sig)
+        (*d_sig).set_frequency((-1)*double(d_f_est) );
+}
+
 
 } /* namespace lte */
 } /* namespace gr */
@@ -22,6 +22,7 @@
 #define INCLUDED_LTE_MIMO_PSS_FREQ_SYNC_IMPL_H
 
 #include <lte/mimo_pss_freq_sync.h>
+#include <fftw3.h>
 
 namespace gr {
   namespace lte {
@@ -29,6 +30,9 @@ namespace gr {
     class mimo_pss_freq_sync_impl : public mimo_pss_freq_sync
     {
      private:
+       // integer offsets in [-d_MAX_INT_OFF, d_MAX_INT_OFF] subcarriers are searched
+       static const int d_MAX_INT_OFF = 5;
+
        int d_fftl;
        int d_rxant;
        int d_N_id_2;
@@ -40,7 +44,14 @@ namespace gr {
        gr_complex *d_pssX;
        gr_complex **d_buf_pss;
 
+       // conjugate PSS and its subcarriers in frequency domain
+       gr_complex d_pss_f[62];
+       int d_pss_bin[62];
+       gr_complex *d_fft_out;
+       fftwf_plan d_plan;
+
        pmt::pmt_t d_id_key;
+       pmt::pmt_t d_port_freq;
        boost::shared_ptr<gr::analog::sig_source_c> d_sig;
 
        void mult_memcpy(gr_complex** &out,
@@ -48,6 +59,8 @@ namespace gr {
                 int out_pos, int in_pos,
                 int multi, int n);
        void calc_freq_off();
+       int calc_int_freq_off();
+       void set_freq_est(float f_est);
 
 
      public:
@@ -26,29 +26,58 @@
 #include "mimo_remove_cp_impl.h"
 
 #include <cstdio>
+#include <cstring>
+#include <stdexcept>
 
 namespace gr {
   namespace lte {
 
     mimo_remove_cp::sptr
-    mimo_remove_cp::make(int fftl, int rxant, std::string key)
+    mimo_remove_cp::make(int fftl, int rxant, std::string key, int N_rb_dl)
     {
-      return gnuradio::get_initial_sptr(new mimo_remove_cp_impl(fftl, rxant, key));
+      return gnuradio::get_initial_sptr(new mimo_remove_cp_impl(fftl, rxant, key, N_rb_dl));
+    }
+
+    static gr::io_signature::sptr
+    output_signature(int fftl, int rxant, int N_rb_dl)
+    {
+      // demodulator mode: one stream with the subcarriers of all antennas
+      if(N_rb_dl > 0){
+        return gr::io_signature::make(1, 1, sizeof(gr_complex) * 12 * N_rb_dl * rxant);
+      }
+      return gr::io_signature::make(1, 8, sizeof(gr_complex) * fftl);
     }
 
     /*
      * The private constructor
      */
-    mimo_remove_cp_impl::mimo_remove_cp_impl(int fftl, int rxant, std::string key) :
+    mimo_remove_cp_impl::mimo_remove_cp_impl(int fftl, int rxant, std::string key, int N_rb_dl) :
             gr::block("mimo_remove_cp", gr::io_signature::make(1, 8, sizeof(gr_complex)),
-                      gr::io_signature::make(1, 8, sizeof(gr_complex) * fftl)), d_fftl(fftl),
+                      output_signature(fftl, rxant, N_rb_dl)), d_fftl(fftl),
             d_rxant(rxant), d_cpl((144 * fftl) / 2048), d_cpl0((160 * fftl) / 2048),
             d_slotl(7 * fftl + 6 * d_cpl + d_cpl0), d_symb(0), d_sym_num(0), d_work_call(0),
-            d_found_frame_start(false), d_half_frame_start(0), d_symbols_per_frame(140)
+            d_found_frame_start(false), d_half_frame_start(0), d_symbols_per_frame(140),
+            d_N_rb_dl(N_rb_dl), d_plan_batch(NULL), d_plan_sym(NULL)
     {
       d_key = pmt::string_to_symbol(key);
       d_tag_id = pmt::string_to_symbol(this->name());
       set_tag_propagation_policy(TPP_DONT);
+
+      if(d_N_rb_dl > 0){
+        if(12 * d_N_rb_dl >= d_fftl){
+          throw std::invalid_argument("mimo_remove_cp: 12 * N_rb_dl must be smaller than fftl");
+        }
+        // d_BATCH_SYMS consecutive symbols of all antennas in one plan, batches start
+        // wherever a work call starts, not at slot boundaries. The remainder of a
+        // work call goes symbol by symbol, all antennas at once.
+        int n = d_fftl;
+        d_fft_buf.resize(d_BATCH_SYMS * d_rxant * d_fftl);
+        fftwf_complex* buf = reinterpret_cast<fftwf_complex*>(d_fft_buf.data());
+        d_plan_batch = fftwf_plan_many_dft(1, &n, d_BATCH_SYMS * d_rxant, buf, NULL, 1, n,
+                                           buf, NULL, 1, n, FFTW_FORWARD, FFTW_ESTIMATE);
+        d_plan_sym = fftwf_plan_many_dft(1, &n, d_rxant, buf, NULL, 1, n,
+                                         buf, NULL, 1, n, FFTW_FORWARD, FFTW_ESTIMATE);
+      }
     }
 
     const int
@@ -122,6 +151,10 @@ namespace gr {
      */
     mimo_remove_cp_impl::~mimo_remove_cp_impl()
     {
+      if(d_N_rb_dl > 0){
+        fftwf_destroy_plan(d_plan_batch);
+        fftwf_destroy_plan(d_plan_sym);
+      }
     }
 
     void
@@ -190,8 +223,14 @@ namespace gr {
       int sync_delay = calculate_item_offset(v);
 
       // Copy the samples of interest from input to output buffer
-      long consumed_items = copy_samples_from_in_to_out(output_items, input_items, noutput_items,
-                                                        sync_delay);
+      long consumed_items;
+      if(d_N_rb_dl > 0){
+        consumed_items = demodulate(output_items, input_items, noutput_items, sync_delay);
+      }
+      else{
+        consumed_items = copy_samples_from_in_to_out(output_items, input_items, noutput_items,
+                                                     sync_delay);
+      }
 
       // add item tags. Item tags for each vector/OFDM symbol.
       add_tags_to_vectors(noutput_items);
@@ -234,6 +273,53 @@ namespace gr {
       return consumed_items;
     }
 
+    long
+    mimo_remove_cp_impl::demodulate(gr_vector_void_star &output_items,
+                                    const gr_vector_const_void_star &input_items,
+                                    int noutput_items, int sync_delay)
+    {
+      const int half = 6 * d_N_rb_dl;
+      const int vector_byte_size = sizeof(gr_complex) * d_fftl;
+      gr_complex *out = (gr_complex*) output_items[0];
+      long consumed_items = 0;
+
+      for(int i = 0; i < noutput_items; i += d_BATCH_SYMS){
+        const int nsyms = noutput_items - i < d_BATCH_SYMS ? noutput_items - i : d_BATCH_SYMS;
+
+        // copy the CP-free symbols of all antennas, symbol by symbol
+        gr_complex *buf = d_fft_buf.data();
+        for(int s = 0; s < nsyms; s++){
+          const int cp_length = (d_symb == 0) ? d_cpl0 : d_cpl;
+          for(int rx = 0; rx < d_rxant; rx++){
+            const gr_complex *in = (const gr_complex *) input_items[rx];
+            memcpy(buf, in + sync_delay + consumed_items + cp_length, vector_byte_size);
+            buf += d_fftl;
+          }
+          consumed_items += d_fftl + cp_length;
+          d_symb = (d_symb + 1) % 7;
+        }
+
+        if(nsyms == d_BATCH_SYMS){
+          fftwf_execute(d_plan_batch);
+        }
+        else{
+          for(int s = 0; s < nsyms; s++){
+            fftwf_complex *sym = reinterpret_cast<fftwf_complex*>(d_fft_buf.data() + s * d_rxant * d_fftl);
+            fftwf_execute_dft(d_plan_sym, sym, sym);
+          }
+        }
+
+        // occupied subcarriers of each antenna, DC is skipped
+        for(int v = 0; v < nsyms * d_rxant; v++){
+          const gr_complex *sym = d_fft_buf.data() + v * d_fftl;
+          memcpy(out, sym + d_fftl - half, sizeof(gr_complex) * half);
+          memcpy(out + half, sym + 1, sizeof(gr_complex) * half);
+          out += 2 * half;
+        }
+      }
+      return consumed_items;
+    }
+
     void
     mimo_remove_cp_impl::add_tags_to_vectors(int noutput_items)
     {
@@ -22,6 +22,8 @@
 #define INCLUDED_LTE_MIMO_REMOVE_CP_IMPL_H
 
 #include <lte/mimo_remove_cp.h>
+#include "aligned_buffer.h"
+#include <fftw3.h>
 
 namespace gr {
   namespace lte {
@@ -50,9 +52,20 @@ namespace gr {
       long d_half_frame_start;
       sync_state d_state;
 
+      // demodulator mode, consecutive symbols per batched FFT
+      static const int d_BATCH_SYMS = 7;
+      int d_N_rb_dl;
+      // CP-free symbols of all antennas, symbol major, transformed in place
+      aligned_buffer<gr_complex> d_fft_buf;
+      fftwf_plan d_plan_batch;
+      fftwf_plan d_plan_sym;
+
       long copy_samples_from_in_to_out(gr_vector_void_star &output_items,
                                   const gr_vector_const_void_star &input_items, int noutput_items,
                                   int sync_delay);
+      long demodulate(gr_vector_void_star &output_items,
+                      const gr_vector_const_void_star &input_items, int noutput_items,
+                      int sync_delay);
       //void add_tags_to_vectors(int noutput_items, int sym_num, int symbols_per_frame);
       void add_tags_to_vectors(int noutput_items);
 
@@ -61,7 +74,7 @@ namespace gr {
       const int calculate_item_offset(std::vector<gr::tag_t>& v);
 
     public:
-      mimo_remove_cp_impl(int fftl, int rxant, std::string key);
+      mimo_remove_cp_impl(int fftl, int rxant, std::string key, int N_rb_dl);
       ~mimo_remove_cp_impl();
 
       // Where all the action really happens
@@ -26,6 +26,7 @@
 #include "mimo_sss_calculator_impl.h"
 #include <volk/volk.h>
 #include <cstdio>
+#include <stdexcept>
 
 #include <boost/multi_array.hpp>
 
@@ -57,6 +58,10 @@ namespace gr {
                 d_is_locked(false),
                 d_unchanged_id(0)
     {
+        if(rxant < 1 || rxant > d_MAX_RXANT){
+            throw std::invalid_argument("mimo_sss_calculator: rxant must be in [1, 8]");
+        }
+
         d_key_offset = pmt::string_to_symbol("offset");
 
         // Get needed message ports!
@@ -78,23 +83,6 @@ namespace gr {
             d_cX[i] = 1-2*cX_x[i];
         }
 
-        //initialize d_sref
-        int m0_ref=0;
-        char sX_x[31]={0};
-        sX_x[4]=1;
-        for(int i = 0; i < 26 ; i++){
-            sX_x[i+5] = (sX_x[i+2] + sX_x[i])%2;
-        }
-        gr_complex sX[31]={0};
-        for(int i = 0 ; i < 31 ; i++){
-            sX[i] = 1-2*sX_x[i];
-        }
-        int m0 = 0;
-        for(int i = 0 ; i < 31 ; i++){
-            d_sref[i   ]=sX[ (i+m0)%31 ];
-            d_sref[i+31]=sX[ (i+m0)%31 ];
-        }
-
         //initialize d_zX
         char zX_x[31] = {0};
         zX_x[4] = 1;
@@ -105,24 +93,12 @@ namespace gr {
             d_zX[i] = 1 - (2*zX_x[i]);
         }
 
-        //initialize m0/m1 pair lookup table
-        for(int i = 0 ; i < 168 ; i++){
-            int N = i;
-            int q_prime = floor(N/30);
-            int q = floor( ( N + (q_prime*(q_prime+1)/2) )/30 );
-            int m_prime = N + q * (q+1)/2;
-            int m0g = m_prime%31;
-            int m1g = (m0g + int(floor(m_prime/31))+1 )%31;
-            d_v_m0[i] = m0g;
-            d_v_m1[i] = m1g;
-        }
-
     }
 
 
     void
     mimo_sss_calculator_impl::msg_set_N_id_2(pmt::pmt_t msg){
-        d_N_id_2 = int(pmt::to_long(msg));
+        set_N_id_2(int(pmt::to_long(msg)));
     }
 
     /*
@@ -145,39 +121,14 @@ namespace gr {
 
         if(d_N_id_2 < 0){return 1;} // can't start yet
 
-        // extract the 2 half sss symbols which are interleaved differently by their position within a frame.
-        gr_complex** even = new gr_complex*[d_rxant];
-        gr_complex** odd  = new gr_complex*[d_rxant];
-
-
-        for(int rx=0; rx<d_rxant; rx++)
-        {
-            even[rx] = new gr_complex[31];
-            odd[rx] = new gr_complex[31];
-            for(int i = 0; i < 31 ; i++){
-
-                  even[rx][i] = in[5 + 2*i + 0 + 72*rx];
-                  odd[rx][i]  = in[5 + 2*i + 1 + 72*rx];
-            }
-        }
-
-        sss_info info = get_sss_info(even, odd, d_N_id_2, d_rxant);
-        //delete used arrays
-        for(int rx=0; rx<d_rxant; rx++){
-            delete[] even[rx];
-            delete[] odd[rx];
-        }
-        delete[] even;
-        delete[] odd;
-
+        sss_info info = get_sss_info(in);
         if(info.N_id_1 < 0){return 1;} // couldn't find valid SSS symbol.
 
         if(d_max_val_new > d_max_val_old*0.8){
             long offset = 0;
-            std::vector <gr::tag_t> v_off;
-            get_tags_in_range(v_off,0, nitems_read(0), nitems_read(0)+1, d_key_offset);
-            if (v_off.size() > 0){
-                offset = pmt::to_long(v_off[0].value);
+            get_tags_in_range(d_v_off,0, nitems_read(0), nitems_read(0)+1, d_key_offset);
+            if (d_v_off.size() > 0){
+                offset = pmt::to_long(d_v_off[0].value);
             }
 
             d_sss_pos = info.pos;
@@ -210,40 +161,36 @@ namespace gr {
     }
 
     sss_info
-    mimo_sss_calculator_impl::get_sss_info(gr_complex** even, gr_complex** odd, int N_id_2, int rxant)
+    mimo_sss_calculator_impl::get_sss_info(const gr_complex* in)
     {
         sss_info info;
         // next 2 sequences depend on N_id_2
-        gr_complex c0[31] = {0};
-        gr_complex c1[31] = {0};
+        char c0[31];
+        char c1[31];
         for(int i = 0; i < 31 ; i++){
             c0[i] = d_cX[ (i+d_N_id_2  )%31 ];
             c1[i] = d_cX[ (i+d_N_id_2+3)%31 ];
         }
 
-        gr_complex** s0m0 = new gr_complex* [rxant];
-        for(int rx=0; rx<rxant; rx++){
-            s0m0[rx] = new gr_complex[31];
-            for (int i = 0 ; i < 31 ; i++){
-                s0m0[rx][i]=even[rx][i]/gr_complex(c0[i]);
+        // the 2 half sss symbols are interleaved differently by their position within a frame.
+        // all scrambling sequences are NRZ coded, thus descrambling flips signs.
+        for(int rx = 0; rx < d_rxant; rx++){
+            const gr_complex* even = in + 5 + 72*rx;
+            for(int i = 0; i < 31 ; i++){
+                d_s0m0[rx][i] = c0[i] > 0 ? even[2*i] : -even[2*i];
             }
         }
 
-        int m0 = calc_m(s0m0, rxant);
+        int m0 = calc_m(d_s0m0);
 
-        char z1m0[31] = {0};
-        for (int i = 0 ; i < 31 ; i++) {
-            z1m0[i] = d_zX[ ( i+(m0%8) )%31 ];
-        }
-
-        gr_complex** s1m1 = new gr_complex*[rxant];
-        for(int rx=0; rx<rxant; rx++){
-            s1m1[rx] = new gr_complex[31];
-            for (int i = 0 ; i < 31 ; i++){
-                s1m1[rx][i] = odd[rx][i] / (c1[i] * gr_complex(z1m0[i]) );
+        for(int rx = 0; rx < d_rxant; rx++){
+            const gr_complex* odd = in + 5 + 1 + 72*rx;
+            for(int i = 0; i < 31 ; i++){
+                char z1m0 = d_zX[ ( i+(m0%8) )%31 ];
+                d_s1m1[rx][i] = c1[i] == z1m0 ? odd[2*i] : -odd[2*i];
             }
         }
-        int m1 = calc_m(s1m1, rxant);
+        int m1 = calc_m(d_s1m1);
         //printf("m1 = %i\n",m1);
 
         info.pos = 0;
@@ -252,104 +199,36 @@ namespace gr {
             info.pos = 5;
         }
         info.N_id_1 = get_N_id_1(m0, m1);
-
-        for(int rx=0; rx<rxant; rx++){
-            delete[] s0m0[rx];
-            delete[] s1m1[rx];
-        }
-
-        delete[] s0m0;
-        delete[] s1m1;
         return info;
     }
 
     int
     mimo_sss_calculator_impl::get_N_id_1(int m0, int m1)
     {
-        int N_id_1 = -1;
-        for(int i = 0 ; i < 168 ; i++ ){
-            if(d_v_m0[i] == m0 && d_v_m1[i] == m1){
-                N_id_1 = i;
-                break;
-            }
-        }
-        return N_id_1;
+        return d_sss.N_id_1(m0, m1);
     }
 
     int
-    mimo_sss_calculator_impl::calc_m(gr_complex **s0m0, int rxant)
+    mimo_sss_calculator_impl::calc_m(const gr_complex (*s0m0)[31])
     {
-        int mX = -1;
-        const int N = 62;
-
-        const int ncorr_vals = 2 * N - 1;
-        std::vector<float> x_vec(ncorr_vals, 0.0f);
-        std::vector<float> tmp;
-        for(int rx = 0; rx < rxant; rx++){
-          xcorr(tmp, s0m0[rx], d_sref, N);
-          for(int i = 0 ; i < x_vec.size(); i++){
-            x_vec[i] += tmp[i];
-          }
+        // all 31 cyclic shifts, magnitudes summed over rx antennas
+        float metric[31] = {0};
+        for(int rx = 0; rx < d_rxant; rx++){
+            d_sss.add_shift_metrics(metric, s0m0[rx]);
         }
 
-        int pos = max_element_position(x_vec);
-        float max = x_vec[pos];
-
-        mX = abs(pos-31-31);
+        int mX = 0;
+        for(int m = 1; m < 31; m++){
+            if(metric[m] > metric[mX]){
+                mX = m;
+            }
+        }
 
-        d_max_val_new = (d_max_val_new + max)/2;
+        d_max_val_new = (d_max_val_new + metric[mX])/2;
 
         return mX;
     }
 
-    int
-    mimo_sss_calculator_impl::max_element_position(const std::vector<float> &v)
-    {
-      float max = 0;
-      int pos = -1;
-      for (int i = 0 ; i < v.size() ; i++){
-          float mag = v[i];
-          if (max < mag){
-              max = mag;
-              pos = i;
-          }
-      }
-      return pos;
-    }
-
-    // simple correlation between 2 arrays. returns complex value.
-    gr_complex
-    mimo_sss_calculator_impl::corr(const gr_complex *x, const gr_complex *y, int len)
-    {
-        gr_complex val = 0;
-        for(int i = 0 ; i < len ; i++){
-            val += (x[i]*conj(y[i]) );
-        }
-        return val;
-    }
-
-    // be careful! input arrays must have the same size!
-    void
-    mimo_sss_calculator_impl::xcorr(std::vector<float> &v, const gr_complex *x,
-                                    const gr_complex *y, int len)
-    {
-      int N = len;
-      int ncorr_vals = 2 * N - 1;
-      if(v.size() > 0){
-        v.clear();
-      }
-      v.resize(ncorr_vals, 0.0f);
-
-      for(int i = 0; i < ncorr_vals; i++){
-        if(i < N){
-          v[i] += abs(corr(x + (N - 1 - i), y, i + 1));
-        }
-        else{
-          v[i] += abs(corr(x, y + (i - N), 2 * N - 1 - i));
-        }
-      }
-    }
-
     void
     mimo_sss_calculator_impl::publish_cell_id(int cell_id)
     {
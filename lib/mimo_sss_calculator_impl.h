@@ -22,6 +22,7 @@
 #define INCLUDED_LTE_MIMO_SSS_CALCULATOR_IMPL_H
 
 #include <lte/mimo_sss_calculator.h>
+#include "sss_detector.h"
 
 namespace gr {
   namespace lte {
@@ -35,16 +36,20 @@ namespace gr {
     class mimo_sss_calculator_impl : public mimo_sss_calculator
     {
      private:
+        static const int d_MAX_RXANT = 8;
+
         int d_N_id_2;
         int d_cell_id;
         int d_fftl;
         int d_rxant;
         int d_slotl;
         char d_cX[31];
-        gr_complex d_sref[62];
         char d_zX[31];
-        int d_v_m0[168];
-        int d_v_m1[168];
+        sss_detector d_sss;
+        // descrambled half sss sequences of each rx antenna
+        gr_complex d_s0m0[d_MAX_RXANT][31];
+        gr_complex d_s1m1[d_MAX_RXANT][31];
+        std::vector<gr::tag_t> d_v_off;
         float d_max_val_new;
         float d_max_val_old;
         int d_sss_pos;
@@ -59,12 +64,9 @@ namespace gr {
 
 
         // calculation functions!
-        int calc_m(gr_complex **s0m0, int rxant);
+        int calc_m(const gr_complex (*s0m0)[31]);
         int get_N_id_1(int m0, int m1);
-        sss_info get_sss_info(gr_complex** even, gr_complex** odd, int N_id_2, int rxant);
-        gr_complex corr(const gr_complex *x, const gr_complex *y, int len);
-        void xcorr(std::vector<float> &v, const gr_complex *x, const gr_complex *y, int len);
-        int max_element_position(const std::vector<float> &v);
+        sss_info get_sss_info(const gr_complex* in);
         void msg_set_N_id_2(pmt::pmt_t msg);
 
         pmt::pmt_t d_port_cell_id;
@@ -81,6 +83,7 @@ namespace gr {
 	       gr_vector_const_void_star &input_items,
 	       gr_vector_void_star &output_items);
 
+      void set_N_id_2(int N_id_2){d_N_id_2 = N_id_2;}
       int get_cell_id(){return d_cell_id;}
       long get_frame_start(){return d_frame_start;}
     };
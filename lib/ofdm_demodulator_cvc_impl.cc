@@ -0,0 +1,239 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "ofdm_demodulator_cvc_impl.h"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+  namespace lte {
+
+    ofdm_demodulator_cvc::sptr
+    ofdm_demodulator_cvc::make(int N_rb_dl, int fftl, std::string key, std::string name)
+    {
+      return gnuradio::get_initial_sptr
+        (new ofdm_demodulator_cvc_impl(N_rb_dl, fftl, key, name));
+    }
+
+    /*
+     * The private constructor
+     */
+    ofdm_demodulator_cvc_impl::ofdm_demodulator_cvc_impl(int N_rb_dl, int fftl, std::string key, std::string& name)
+      : gr::block(name,
+              gr::io_signature::make( 1, 1, sizeof(gr_complex)),
+              gr::io_signature::make( 1, 1, sizeof(gr_complex) * 12 * N_rb_dl)),
+              d_N_rb_dl(N_rb_dl),
+              d_fftl(fftl),
+              d_cpl((144*fftl)/2048),
+              d_cpl0((160*fftl)/2048),
+              d_slotl(7*fftl+6*d_cpl+d_cpl0),
+              d_symb(0),
+              d_sym_num(0),
+              d_found_frame_start(false),
+              d_frame_start(0)
+    {
+        if(N_rb_dl < 1 || 12 * N_rb_dl >= fftl){
+            throw std::invalid_argument("ofdm_demodulator_cvc: 12 * N_rb_dl must be in [12, fftl)");
+        }
+        d_slot_key = pmt::string_to_symbol("slot");
+        d_key = pmt::string_to_symbol(key);
+        d_tag_id = pmt::string_to_symbol(this->name());
+        set_tag_propagation_policy(TPP_DONT);
+
+        d_plan_in.resize(d_SLOT_SYMS * (d_fftl + d_cpl) + 1);
+        d_fft_out.resize(d_SLOT_SYMS * d_fftl);
+        fftwf_complex* out = reinterpret_cast<fftwf_complex*>(d_fft_out.data());
+
+        // the symbols of a batch are d_fftl + d_cpl apart in the input and
+        // d_fftl apart in the output
+        fftwf_iodim dim = {d_fftl, 1, 1};
+        fftwf_iodim batch = {d_SLOT_SYMS, d_fftl + d_cpl, d_fftl};
+        for(int k = 0; k < 2; k++){
+            gr_complex* in = d_plan_in.data() + k;
+            d_align[k] = fftwf_alignment_of(reinterpret_cast<float*>(in));
+            d_plan[PLAN_SYM][k] = fftwf_plan_guru_dft(1, &dim, 0, NULL,
+                                                      reinterpret_cast<fftwf_complex*>(in), out,
+                                                      FFTW_FORWARD, FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
+            d_plan[PLAN_SLOT][k] = fftwf_plan_guru_dft(1, &dim, 1, &batch,
+                                                       reinterpret_cast<fftwf_complex*>(in), out,
+                                                       FFTW_FORWARD, FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
+        }
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    ofdm_demodulator_cvc_impl::~ofdm_demodulator_cvc_impl()
+    {
+        for(int p = 0; p < N_PLANS; p++){
+            for(int k = 0; k < 2; k++){
+                fftwf_destroy_plan(d_plan[p][k]);
+            }
+        }
+    }
+
+    void
+    ofdm_demodulator_cvc_impl::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+    {
+        unsigned ninputs = ninput_items_required.size();
+        for (unsigned i = 0; i < ninputs; i++)
+            ninput_items_required[i] = ( d_fftl + d_cpl0 ) * noutput_items;
+    }
+
+    int
+    ofdm_demodulator_cvc_impl::general_work (int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+    {
+        const gr_complex *in = (const gr_complex *) input_items[0];
+        gr_complex *out = (gr_complex *) output_items[0];
+
+        std::vector <gr::tag_t> v;
+        get_tags_in_range(v, 0, nitems_read(0), nitems_read(0) + noutput_items * (d_fftl + d_cpl0), d_slot_key);
+
+        // drop samples up to the first frame start
+        if(!d_found_frame_start){
+            if(!find_frame_start(v)){
+                consume_each(noutput_items * (d_fftl + d_cpl0));
+            }
+            return 0;
+        }
+        if(!check_sync(v)){
+            return 0;
+        }
+
+        long consumed_items = demodulate(out, in, noutput_items);
+        add_tags_to_vectors(noutput_items);
+
+        consume_each(consumed_items);
+        return noutput_items;
+    }
+
+    bool
+    ofdm_demodulator_cvc_impl::find_frame_start(const std::vector<gr::tag_t> &v)
+    {
+        for(unsigned int i = 0; i < v.size(); i++){
+            if(pmt::to_long(v[i].value) == 0){
+                d_frame_start = v[i].offset % (20 * d_slotl);
+                d_symb = 0;
+                d_sym_num = 0;
+                d_found_frame_start = true;
+                consume_each(int(v[i].offset - nitems_read(0)));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool
+    ofdm_demodulator_cvc_impl::check_sync(const std::vector<gr::tag_t> &v)
+    {
+        for(unsigned int i = 0; i < v.size(); i++){
+            if(pmt::to_long(v[i].value) == 0 && long(v[i].offset % (20 * d_slotl)) != d_frame_start){
+                printf("%s OUT of sync!\n", name().c_str());
+                d_found_frame_start = false;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void
+    ofdm_demodulator_cvc_impl::transform(int plan, const gr_complex* in)
+    {
+        fftwf_complex* out = reinterpret_cast<fftwf_complex*>(d_fft_out.data());
+        // FFTW_PRESERVE_INPUT, the input buffer is not written
+        gr_complex* buf = const_cast<gr_complex*>(in);
+        const int align = fftwf_alignment_of(reinterpret_cast<float*>(buf));
+        for(int k = 0; k < 2; k++){
+            if(align == d_align[k]){
+                fftwf_execute_dft(d_plan[plan][k], reinterpret_cast<fftwf_complex*>(buf), out);
+                return;
+            }
+        }
+
+        // only if FFTW requires a wider alignment than a sample
+        const int len = plan == PLAN_SYM ? d_fftl : (d_SLOT_SYMS - 1) * (d_fftl + d_cpl) + d_fftl;
+        memcpy(d_plan_in.data(), in, sizeof(gr_complex) * len);
+        fftwf_execute_dft(d_plan[plan][0], reinterpret_cast<fftwf_complex*>(d_plan_in.data()), out);
+    }
+
+    long
+    ofdm_demodulator_cvc_impl::demodulate(gr_complex* out, const gr_complex* in, int noutput_items)
+    {
+        const int half = 6 * d_N_rb_dl;
+        long consumed_items = 0;
+        int i = 0;
+        while(i < noutput_items){
+            int nsyms = 1;
+            int len;
+            if(d_symb == 0){ // 0. symbol in each LTE slot is longer than the rest
+                transform(PLAN_SYM, in + d_cpl0);
+                len = d_fftl + d_cpl0;
+            }
+            else if(d_symb == 1 && noutput_items - i >= d_SLOT_SYMS){
+                transform(PLAN_SLOT, in + d_cpl);
+                nsyms = d_SLOT_SYMS;
+                len = d_SLOT_SYMS * (d_fftl + d_cpl);
+            }
+            else{
+                transform(PLAN_SYM, in + d_cpl);
+                len = d_fftl + d_cpl;
+            }
+
+            // occupied subcarriers only, DC is skipped
+            for(int s = 0; s < nsyms; s++){
+                const gr_complex* sym = d_fft_out.data() + s * d_fftl;
+                memcpy(out, sym + d_fftl - half, sizeof(gr_complex) * half);
+                memcpy(out + half, sym + 1, sizeof(gr_complex) * half);
+                out += 2 * half;
+            }
+
+            in += len;
+            consumed_items += len;
+            i += nsyms;
+            d_symb = (d_symb + nsyms) % 7;
+        }
+        return consumed_items;
+    }
+
+    void
+    ofdm_demodulator_cvc_impl::add_tags_to_vectors(int noutput_items)
+    {
+        for (int i = 0 ; i < noutput_items ; i++){
+            if(d_sym_num%7 == 0){
+                add_item_tag(0,nitems_written(0)+i,d_key, pmt::from_long(d_sym_num),d_tag_id);
+            }
+            d_sym_num=(d_sym_num+1)%140;
+        }
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
@@ -0,0 +1,84 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_LTE_OFDM_DEMODULATOR_CVC_IMPL_H
+#define INCLUDED_LTE_OFDM_DEMODULATOR_CVC_IMPL_H
+
+#include <lte/ofdm_demodulator_cvc.h>
+#include "aligned_buffer.h"
+#include <fftw3.h>
+
+namespace gr {
+  namespace lte {
+
+    class ofdm_demodulator_cvc_impl : public ofdm_demodulator_cvc
+    {
+     private:
+      // plans for one symbol and for the 6 symbols with short CP of a slot
+      enum { PLAN_SYM, PLAN_SLOT, N_PLANS };
+      static const int d_SLOT_SYMS = 6;
+
+      int d_N_rb_dl;
+      int d_fftl;
+      int d_cpl;
+      int d_cpl0;
+      int d_slotl;
+      int d_symb;     // symbol number within slot
+      int d_sym_num;  // symbol number within frame
+      // input slot tags of sss_tagger_cc / mimo_sss_tagger, output symbol tags
+      pmt::pmt_t d_slot_key;
+      pmt::pmt_t d_key;
+      pmt::pmt_t d_tag_id;
+      bool d_found_frame_start;
+      long d_frame_start;
+
+      // FFTW only executes a plan on arrays with the alignment it was
+      // planned for. Input symbols start at odd or even samples, thus
+      // each plan exists for both input alignments.
+      fftwf_plan d_plan[N_PLANS][2];
+      int d_align[2];
+      aligned_buffer<gr_complex> d_plan_in;
+      aligned_buffer<gr_complex> d_fft_out;
+
+      bool find_frame_start(const std::vector<gr::tag_t> &v);
+      bool check_sync(const std::vector<gr::tag_t> &v);
+      void transform(int plan, const gr_complex* in);
+      long demodulate(gr_complex* out, const gr_complex* in, int noutput_items);
+      void add_tags_to_vectors(int noutput_items);
+
+     public:
+      ofdm_demodulator_cvc_impl(int N_rb_dl, int fftl, std::string key, std::string& name);
+      ~ofdm_demodulator_cvc_impl();
+
+      // Where all the action really happens
+      void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+		       gr_vector_int &ninput_items,
+		       gr_vector_const_void_star &input_items,
+		       gr_vector_void_star &output_items);
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_OFDM_DEMODULATOR_CVC_IMPL_H */
+
@@ -0,0 +1,291 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "pbch_decoder_vcvf_impl.h"
+#include <lte/gold_sequence.h>
+
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gr {
+  namespace lte {
+
+    pbch_decoder_vcvf::sptr
+    pbch_decoder_vcvf::make(int N_rb_dl, int rxant, std::string key, std::string name)
+    {
+      return gnuradio::get_initial_sptr
+        (new pbch_decoder_vcvf_impl(N_rb_dl, rxant, key, name));
+    }
+
+    /*
+     * The private constructor
+     */
+    pbch_decoder_vcvf_impl::pbch_decoder_vcvf_impl(int N_rb_dl, int rxant, std::string key, std::string name)
+      : gr::block(name,
+              gr::io_signature::make( 3, 3, sizeof(gr_complex) * 12 * N_rb_dl * rxant),
+              gr::io_signature::make( 1, 1, sizeof(float) * d_CW_LEN)),
+              d_N_rb_dl(N_rb_dl),
+              d_rxant(rxant),
+              d_n_carriers(12 * N_rb_dl),
+              d_sym_num(-1),
+              d_cell_id(-1),
+              d_pending_cell_id(-1),
+              d_re_pos(d_N_PBCH),
+              d_pn_seq(d_PN_SEQ_LEN),
+              d_rx(d_N_PBCH * rxant),
+              d_ce0(d_N_PBCH * rxant),
+              d_ce1(d_N_PBCH * rxant),
+              d_soft(4 * d_N_PBCH)
+    {
+        set_output_multiple(d_ITEMS_PER_PBCH);
+        d_key = pmt::string_to_symbol(key);
+
+        message_port_register_in(pmt::mp("cell_id"));
+        set_msg_handler(pmt::mp("cell_id"), boost::bind(&pbch_decoder_vcvf_impl::set_cell_id_msg, this, _1));
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    pbch_decoder_vcvf_impl::~pbch_decoder_vcvf_impl()
+    {
+    }
+
+    void
+    pbch_decoder_vcvf_impl::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+    {
+        // At most one PBCH starts per frame, 4 symbols are needed to decode it.
+        int n_pbch = noutput_items / d_ITEMS_PER_PBCH;
+        for(unsigned int i = 0 ; i < ninput_items_required.size() ; i++){
+            ninput_items_required[i] = d_N_PBCH_SYMS * std::max(1, n_pbch);
+        }
+    }
+
+    int
+    pbch_decoder_vcvf_impl::general_work (int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+    {
+        apply_pending_cell_id();
+
+        const gr_complex *in = (const gr_complex *) input_items[0];
+        const gr_complex *ce0 = (const gr_complex *) input_items[1];
+        const gr_complex *ce1 = (const gr_complex *) input_items[2];
+        float *out = (float *) output_items[0];
+
+        int ninitems = std::min(ninput_items[0], std::min(ninput_items[1], ninput_items[2]));
+        int vlen = d_n_carriers * d_rxant;
+        int produced = 0;
+
+        std::vector<gr::tag_t> v;
+        get_tags_in_range(v, 0, nitems_read(0), nitems_read(0) + ninitems, d_key);
+        int sym_num = get_sym_num(v);
+
+        for(int i = 0 ; i < ninitems ; i++){
+            if(sym_num == 7){
+                if(ninitems - i < d_N_PBCH_SYMS || noutput_items - produced < d_ITEMS_PER_PBCH){
+                    ninitems = i;
+                    break;
+                }
+                // Without a cell ID the PBCH REs are unknown, the PBCH is dropped.
+                if(d_cell_id >= 0){
+                    extract_pbch_values(d_rx.data(), in);
+                    extract_pbch_values(d_ce0.data(), ce0);
+                    extract_pbch_values(d_ce1.data(), ce1);
+
+                    decode_1_ant(d_soft.data());
+                    decode_2_ant(d_soft.data() + 2 * d_N_PBCH);
+
+                    descramble(out, d_soft.data());
+                    descramble(out + d_ITEMS_PER_HYP * d_CW_LEN, d_soft.data() + 2 * d_N_PBCH);
+                    out += d_ITEMS_PER_PBCH * d_CW_LEN;
+                    produced += d_ITEMS_PER_PBCH;
+                }
+            }
+
+            if(sym_num != -1){
+                sym_num = (sym_num + 1) % 140;
+            }
+            in += vlen;
+            ce0 += vlen;
+            ce1 += vlen;
+        }
+
+        d_sym_num = sym_num;
+        consume_each(ninitems);
+        return produced;
+    }
+
+    void
+    pbch_decoder_vcvf_impl::extract_pbch_values(gr_complex* out, const gr_complex* in)
+    {
+        for(int rx = 0; rx < d_rxant; rx++){
+            const gr_complex* rx_in = in + rx * d_n_carriers;
+            for(int i = 0; i < d_N_PBCH; i++){
+                out[i] = rx_in[d_re_pos[i]];
+            }
+            out += d_N_PBCH;
+        }
+    }
+
+    void
+    pbch_decoder_vcvf_impl::decode_1_ant(float* soft)
+    {
+        // e_x0 = SUM_X (h_X* r_X) / SUM_X |h_X|², scaled to QPSK soft bits.
+        const float sqrt2 = std::sqrt(2.0f);
+        for(int n = 0; n < d_N_PBCH; n++){
+            gr_complex num(0.0f, 0.0f);
+            float mag = 0.0f;
+            for(int rx = 0; rx < d_rxant; rx++){
+                const gr_complex r = d_rx[rx * d_N_PBCH + n];
+                const gr_complex h = d_ce0[rx * d_N_PBCH + n];
+                num += r * std::conj(h);
+                mag += std::norm(h);
+            }
+            num *= sqrt2 / mag;
+            soft[2 * n] = num.real();
+            soft[2 * n + 1] = num.imag();
+        }
+    }
+
+    void
+    pbch_decoder_vcvf_impl::decode_2_ant(float* soft)
+    {
+        // Alamouti combining as in pre_decoder_vcvc. Layer demapping puts
+        // e_x0 and e_x1 of each carrier pair next to each other again.
+        for(int n = 0; n < d_N_PBCH / 2; n++){
+            gr_complex x0(0.0f, 0.0f);
+            gr_complex x1(0.0f, 0.0f);
+            float mag = 0.0f;
+            for(int rx = 0; rx < d_rxant; rx++){
+                const int idx = rx * d_N_PBCH + 2 * n;
+                const gr_complex h0 = (d_ce0[idx] + d_ce0[idx + 1]) * 0.5f;
+                const gr_complex h1 = (d_ce1[idx] + d_ce1[idx + 1]) * 0.5f;
+                const gr_complex r0 = d_rx[idx];
+                const gr_complex r1 = d_rx[idx + 1];
+                x0 += r0 * std::conj(h0) + h1 * std::conj(r1);
+                x1 += r1 * std::conj(h0) - h1 * std::conj(r0);
+                mag += std::norm(h0) + std::norm(h1);
+            }
+            // sqrt(2) of the pre decoder times sqrt(2) of the soft demodulator
+            const float scale = 2.0f / mag;
+            x0 *= scale;
+            x1 *= scale;
+            soft[4 * n] = x0.real();
+            soft[4 * n + 1] = x0.imag();
+            soft[4 * n + 2] = x1.real();
+            soft[4 * n + 3] = x1.imag();
+        }
+    }
+
+    void
+    pbch_decoder_vcvf_impl::descramble(float* out, const float* soft)
+    {
+        // The frame position within the 40ms period is unknown. Thus all 4
+        // parts of the scrambling sequence are applied. Each part holds 4
+        // codewords which are output as is and soft combined.
+        const int part_len = 2 * d_N_PBCH;
+        for(int p = 0; p < d_N_PARTS; p++){
+            const float* seq = d_pn_seq.data() + p * part_len;
+            volk_32f_x2_multiply_32f_u(out, soft, seq, part_len);
+
+            float* comb = out + part_len;
+            for(int k = 0; k < d_CW_LEN; k++){
+                comb[k] = (out[k] + out[k + d_CW_LEN] + out[k + 2 * d_CW_LEN] + out[k + 3 * d_CW_LEN]) * 0.25f;
+            }
+            out += part_len + d_CW_LEN;
+        }
+    }
+
+    int
+    pbch_decoder_vcvf_impl::get_sym_num(std::vector<gr::tag_t> &v)
+    {
+        int sym_num = d_sym_num;
+        if(v.size() > 0){
+            int value = int(pmt::to_long(v[0].value));
+            int rel_offset = v[0].offset - nitems_read(0);
+            sym_num = (value + 140 - rel_offset) % 140;
+        }
+        return sym_num;
+    }
+
+    void
+    pbch_decoder_vcvf_impl::set_cell_id_msg(pmt::pmt_t msg)
+    {
+        set_cell_id(int(pmt::to_long(msg)));
+    }
+
+    void
+    pbch_decoder_vcvf_impl::set_cell_id(int id)
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_pending_cell_id = id;
+    }
+
+    void
+    pbch_decoder_vcvf_impl::apply_pending_cell_id()
+    {
+        int id;
+        {
+            gr::thread::scoped_lock lock(d_mutex);
+            id = d_pending_cell_id;
+            d_pending_cell_id = -1;
+        }
+        if(id < 0 || id == d_cell_id){
+            return;
+        }
+        init_re_positions(id);
+        // NRZ coded pn sequence, c_init = cell_id
+        gold_sequence::nrz(d_pn_seq.data(), d_PN_SEQ_LEN, id);
+        d_cell_id = id;
+    }
+
+    void
+    pbch_decoder_vcvf_impl::init_re_positions(int cell_id)
+    {
+        // PBCH occupies the 72 center carriers of symbols 7 to 10.
+        // Carriers with cell reference signals are skipped in symbols 7 and 8.
+        int cell_id_mod3 = cell_id % 3;
+        int pbch_pos = (d_n_carriers / 2) - (72 / 2);
+        int sym_len = d_n_carriers * d_rxant;
+        int idx = 0;
+        for(int c = 0; c < 72; c++){
+            if(cell_id_mod3 != c % 3){
+                d_re_pos[idx] = pbch_pos + c;
+                d_re_pos[idx + 48] = pbch_pos + c + sym_len;
+                idx++;
+            }
+        }
+        for(int c = 0; c < 72; c++){
+            d_re_pos[96 + c] = pbch_pos + c + 2 * sym_len;
+            d_re_pos[96 + 72 + c] = pbch_pos + c + 3 * sym_len;
+        }
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
@@ -0,0 +1,93 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_PBCH_DECODER_VCVF_IMPL_H
+#define INCLUDED_LTE_PBCH_DECODER_VCVF_IMPL_H
+
+#include <lte/pbch_decoder_vcvf.h>
+#include <gnuradio/thread/thread.h>
+#include "aligned_buffer.h"
+#include <vector>
+
+namespace gr {
+  namespace lte {
+
+    class pbch_decoder_vcvf_impl : public pbch_decoder_vcvf
+    {
+     private:
+      static const int d_N_PBCH = 240;
+      static const int d_N_PBCH_SYMS = 4;
+      static const int d_PN_SEQ_LEN = 1920;
+      static const int d_N_PARTS = 4;
+      static const int d_CW_LEN = 120;
+      // 16 codewords plus one soft combined codeword per hypothesis and part
+      static const int d_ITEMS_PER_HYP = d_N_PARTS * (d_N_PARTS + 1);
+      static const int d_ITEMS_PER_PBCH = 2 * d_ITEMS_PER_HYP;
+
+      int d_N_rb_dl;
+      int d_rxant;
+      int d_n_carriers;
+      int d_sym_num;
+      int d_cell_id;
+      int d_pending_cell_id;
+      gr::thread::mutex d_mutex;
+      pmt::pmt_t d_key;
+
+      // Offsets of the PBCH REs relative to the first PBCH symbol of rx antenna 0
+      std::vector<int> d_re_pos;
+      aligned_buffer<float> d_pn_seq;
+
+      // PBCH REs of rx and channel estimates, one row of 240 per rx antenna
+      aligned_buffer<gr_complex> d_rx;
+      aligned_buffer<gr_complex> d_ce0;
+      aligned_buffer<gr_complex> d_ce1;
+      // soft bits of hypothesis N_ant = 1 followed by N_ant = 2
+      aligned_buffer<float> d_soft;
+
+      void set_cell_id_msg(pmt::pmt_t msg);
+      void apply_pending_cell_id();
+      void init_re_positions(int cell_id);
+      int get_sym_num(std::vector<gr::tag_t> &v);
+
+      void extract_pbch_values(gr_complex* out, const gr_complex* in);
+      void decode_1_ant(float* soft);
+      void decode_2_ant(float* soft);
+      void descramble(float* out, const float* soft);
+
+     public:
+      pbch_decoder_vcvf_impl(int N_rb_dl, int rxant, std::string key, std::string name);
+      ~pbch_decoder_vcvf_impl();
+
+      void set_cell_id(int id);
+
+      // Where all the action really happens
+      void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items);
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_PBCH_DECODER_VCVF_IMPL_H */
+
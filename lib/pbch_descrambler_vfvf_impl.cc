@@ -24,6 +24,7 @@
 
 #include <gnuradio/io_signature.h>
 #include "pbch_descrambler_vfvf_impl.h"
+#include <lte/gold_sequence.h>
 
 #include <fftw3.h>
 #include <volk/volk.h>
@@ -135,39 +136,6 @@ namespace gr {
 		return 16; // noutput_items;
     }
     
-	char*
-	pbch_descrambler_vfvf_impl::pn_seq_generator(int len, int cell_id)
-	{
-		const int Nc=1600; //Constant is defined in standard
-		int cinit=cell_id;
-
-		__GR_VLA(char, x2, 3 * len + Nc);
-		for (int i = 0; i<31; i++){
-				char val = cinit%2;
-				cinit = floor(cinit/2);
-				x2[i] = val;
-		}
-
-		char *c=new char[len];
-		__GR_VLA(char, x1, 3 * len + Nc);
-		// initialization for first 35 elements is needed. (Otherwise READ BEFORE WRITE ERROR)
-		for (int i = 0 ; i < 35 ; i++){
-			x1[i]=0;
-		}
-		x1[0]=1;
-
-		for (int n=0; n <2*len+Nc-3;n++){
-			x1[n+31]=(x1[n+3]+x1[n])%2;
-			x2[n+31]=(x2[n+3]+x2[n+2]+x2[n+1]+x2[n])%2;
-		}
-
-		for (int n=0;n<len;n++){
-			c[n]=(x1[n+Nc]+x2[n+Nc])%2;
-		}
-
-		return c;
-	}
-
 	std::vector<int>
 	pbch_descrambler_vfvf_impl::pn_sequence() const
 	{
@@ -196,12 +164,8 @@ namespace gr {
 		printf("%s\tset_cell_id = %i\n", name().c_str(), id);
 		//int len=1920;
 		d_pn_seq_len=1920;
-		char *pn_seq0 = pn_seq_generator(d_pn_seq_len, id);
-		//d_pn_seq = new char[len];
-		//NRZ coding of pn sequence
-		for (int i = 0 ; i<d_pn_seq_len; i++){
-			d_pn_seq[i]=1-2*pn_seq0[i];
-		}
+		// NRZ coded pn sequence, c_init = cell_id
+		gold_sequence::nrz(d_pn_seq, d_pn_seq_len, id);
 		d_cell_id = id;
 	}
 
@@ -51,7 +51,6 @@ namespace gr {
 	  void set_cell_id(int id);
 	  void set_cell_id_msg(pmt::pmt_t msg);
 
-	  static char* pn_seq_generator(int len, int cell_id);
 	  std::vector<int> pn_sequence() const;
     };
 
@@ -0,0 +1,111 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "pcfich_scramble_sequencer_m_impl.h"
+#include <lte/gold_sequence.h>
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace gr {
+  namespace lte {
+
+    pcfich_scramble_sequencer_m::sptr
+    pcfich_scramble_sequencer_m::make(std::string name)
+    {
+      return gnuradio::get_initial_sptr(
+          new pcfich_scramble_sequencer_m_impl(name));
+    }
+
+    /*
+     * The private constructor
+     */
+    pcfich_scramble_sequencer_m_impl::pcfich_scramble_sequencer_m_impl(
+        std::string name) :
+        gr::block(name, gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)), d_cell_id(-1), d_table(
+            d_N_SUBFRAMES * d_SEQ_LEN), d_cache(d_N_CELL_IDS, pmt::PMT_NIL)
+    {
+      d_port_in = pmt::mp("cell_id");
+      d_port_out = pmt::mp("descr");
+      message_port_register_in(d_port_in);
+      set_msg_handler(
+          d_port_in,
+          boost::bind(&pcfich_scramble_sequencer_m_impl::handle_msg, this, _1));
+      message_port_register_out(d_port_out);
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    pcfich_scramble_sequencer_m_impl::~pcfich_scramble_sequencer_m_impl()
+    {
+    }
+
+    void
+    pcfich_scramble_sequencer_m_impl::handle_msg(pmt::pmt_t msg)
+    {
+      int cell_id = int(pmt::to_long(msg));
+      if(cell_id == d_cell_id){
+        return;
+      }
+      if(cell_id < 0 || cell_id >= d_N_CELL_IDS){
+        printf("%s invalid cell_id = %i\n", name().c_str(), cell_id);
+        return;
+      }
+      d_cell_id = cell_id;
+      printf("received cell_id = %i\n", cell_id);
+      message_port_pub(d_port_out, descr_table(cell_id));
+    }
+
+    pmt::pmt_t
+    pcfich_scramble_sequencer_m_impl::descr_table(int cell_id)
+    {
+      if(cell_id < 0 || cell_id >= d_N_CELL_IDS){
+        throw std::invalid_argument(
+            "pcfich_scramble_sequencer_m: cell_id must be in [0, 503]");
+      }
+      gr::thread::scoped_lock lock(d_mutex);
+      if(pmt::is_null(d_cache[cell_id])){
+        d_cache[cell_id] = generate_descr_table(cell_id);
+      }
+      return d_cache[cell_id];
+    }
+
+    // 36.211 6.7.1 c_init = (floor(ns / 2) + 1) * (2 * cell_id + 1) * 2^9 + cell_id
+    // ns is the subframe index here, as in the PCFICH test encoder.
+    pmt::pmt_t
+    pcfich_scramble_sequencer_m_impl::generate_descr_table(int cell_id)
+    {
+      for(int ns = 0; ns < d_N_SUBFRAMES; ns++){
+        uint32_t c_init = (ns / 2 + 1) * (2 * cell_id + 1) * 512 + cell_id;
+        gold_sequence::nrz(d_table.data() + ns * d_SEQ_LEN, d_SEQ_LEN, c_init);
+      }
+      return pmt::cons(pmt::from_long(d_N_SUBFRAMES),
+                       pmt::init_f32vector(d_table.size(), d_table.data()));
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
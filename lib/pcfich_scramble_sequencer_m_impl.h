@@ -0,0 +1,62 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_PCFICH_SCRAMBLE_SEQUENCER_M_IMPL_H
+#define INCLUDED_LTE_PCFICH_SCRAMBLE_SEQUENCER_M_IMPL_H
+
+#include <lte/pcfich_scramble_sequencer_m.h>
+#include <gnuradio/thread/thread.h>
+#include "aligned_buffer.h"
+#include <vector>
+
+namespace gr {
+  namespace lte {
+
+    class pcfich_scramble_sequencer_m_impl : public pcfich_scramble_sequencer_m
+    {
+     private:
+      static const int d_N_CELL_IDS = 504;
+      static const int d_N_SUBFRAMES = 10;
+      static const int d_SEQ_LEN = 32;
+
+      int d_cell_id;
+      pmt::pmt_t d_port_in;
+      pmt::pmt_t d_port_out;
+
+      // NRZ sequences of all subframes, one row per subframe.
+      aligned_buffer<float> d_table;
+      // one table message per cell ID, PMT_NIL if not calculated yet.
+      std::vector<pmt::pmt_t> d_cache;
+      gr::thread::mutex d_mutex;
+
+      void handle_msg(pmt::pmt_t msg);
+      pmt::pmt_t generate_descr_table(int cell_id);
+
+     public:
+      pcfich_scramble_sequencer_m_impl(std::string name);
+      ~pcfich_scramble_sequencer_m_impl();
+
+      pmt::pmt_t descr_table(int cell_id);
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_PCFICH_SCRAMBLE_SEQUENCER_M_IMPL_H */
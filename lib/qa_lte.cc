@@ -26,11 +26,13 @@
  */
 
 #include "qa_lte.h"
+#include "qa_mimo_sss_calculator.h"
 
 CppUnit::TestSuite *
 qa_lte::suite()
 {
   CppUnit::TestSuite *s = new CppUnit::TestSuite("lte");
+  s->addTest(gr::lte::qa_mimo_sss_calculator::suite());
 
   return s;
 }
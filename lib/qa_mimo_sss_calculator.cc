@@ -0,0 +1,153 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "qa_mimo_sss_calculator.h"
+#include "mimo_sss_calculator_impl.h"
+#include <gnuradio/block_detail.h>
+#include <gnuradio/buffer.h>
+#include <cppunit/TestAssert.h>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// All allocations of the test executable pass here, bytes are summed while counting.
+static bool s_count_allocs = false;
+static size_t s_alloc_bytes = 0;
+
+#if __cplusplus >= 201103L
+#define QA_NEW_THROW
+#define QA_DELETE_THROW noexcept
+#else
+#define QA_NEW_THROW throw(std::bad_alloc)
+#define QA_DELETE_THROW throw()
+#endif
+
+void*
+operator new(size_t n) QA_NEW_THROW
+{
+  if(s_count_allocs){
+    s_alloc_bytes += n;
+  }
+  void* p = std::malloc(n > 0 ? n : 1);
+  if(!p){
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void
+operator delete(void* p) QA_DELETE_THROW
+{
+  std::free(p);
+}
+
+namespace gr {
+  namespace lte {
+
+    // SSS of subframe 0 and 5 as in 3GPP TS 36.211 6.11.2.1
+    static void
+    gen_sss(gr_complex* sss0, gr_complex* sss5, int cell_id)
+    {
+      int N_id_1 = cell_id / 3;
+      int N_id_2 = cell_id % 3;
+      int q_prime = N_id_1 / 30;
+      int q = (N_id_1 + q_prime * (q_prime + 1) / 2) / 30;
+      int m_prime = N_id_1 + q * (q + 1) / 2;
+      int m0 = m_prime % 31;
+      int m1 = (m0 + m_prime / 31 + 1) % 31;
+
+      int x_s[31] = {0};
+      int x_c[31] = {0};
+      int x_z[31] = {0};
+      x_s[4] = x_c[4] = x_z[4] = 1;
+      for(int i = 0; i < 26; i++){
+        x_s[i+5] = (x_s[i+2] + x_s[i]) % 2;
+        x_c[i+5] = (x_c[i+3] + x_c[i]) % 2;
+        x_z[i+5] = (x_z[i+4] + x_z[i+2] + x_z[i+1] + x_z[i]) % 2;
+      }
+
+      for(int n = 0; n < 31; n++){
+        float s0 = 1 - 2 * x_s[(n + m0) % 31];
+        float s1 = 1 - 2 * x_s[(n + m1) % 31];
+        float c0 = 1 - 2 * x_c[(n + N_id_2) % 31];
+        float c1 = 1 - 2 * x_c[(n + N_id_2 + 3) % 31];
+        float z1m0 = 1 - 2 * x_z[(n + m0 % 8) % 31];
+        float z1m1 = 1 - 2 * x_z[(n + m1 % 8) % 31];
+        sss0[2*n] = s0 * c0;
+        sss0[2*n+1] = s1 * c1 * z1m0;
+        sss5[2*n] = s1 * c0;
+        sss5[2*n+1] = s0 * c1 * z1m1;
+      }
+    }
+
+    void
+    qa_mimo_sss_calculator::t1()
+    {
+      const int rxant = 2;
+      const int cell_id = 124;
+      const int vlen = 72 * rxant;
+
+      gr_complex sss0[62];
+      gr_complex sss5[62];
+      gen_sss(sss0, sss5, cell_id);
+      std::vector<gr_complex> sym0(vlen);
+      std::vector<gr_complex> sym5(vlen);
+      std::vector<gr_complex> zeros(vlen);
+      for(int rx = 0; rx < rxant; rx++){
+        std::copy(sss0, sss0 + 62, sym0.begin() + 5 + 72 * rx);
+        std::copy(sss5, sss5 + 62, sym5.begin() + 5 + 72 * rx);
+      }
+
+      boost::shared_ptr<mimo_sss_calculator_impl> calc =
+        boost::static_pointer_cast<mimo_sss_calculator_impl>(mimo_sss_calculator::make(rxant));
+      // tags are read through the block detail, connect an empty input buffer as a flowgraph would
+      gr::block_detail_sptr detail = gr::make_block_detail(1, 0);
+      gr::buffer_sptr buf = gr::make_buffer(64, sizeof(gr_complex) * vlen, calc);
+      detail->set_input(0, gr::buffer_add_reader(buf, 0, calc));
+      calc->set_detail(detail);
+      calc->set_N_id_2(cell_id % 3);
+
+      gr_vector_const_void_star in(1);
+      gr_vector_void_star out;
+
+      in[0] = &sym0[0];
+      calc->work(1, in, out);
+
+      // symbols without a valid N_id_1 and a valid one which doesn't lock yet
+      s_alloc_bytes = 0;
+      s_count_allocs = true;
+      in[0] = &zeros[0];
+      for(int i = 0; i < 4; i++){
+        calc->work(1, in, out);
+      }
+      in[0] = &sym5[0];
+      calc->work(1, in, out);
+      s_count_allocs = false;
+      CPPUNIT_ASSERT_EQUAL(size_t(0), s_alloc_bytes);
+
+      // the third valid SSS locks
+      in[0] = &sym0[0];
+      calc->work(1, in, out);
+      CPPUNIT_ASSERT_EQUAL(cell_id, calc->get_cell_id());
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
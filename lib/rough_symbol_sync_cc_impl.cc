@@ -24,11 +24,10 @@
 
 #include <gnuradio/io_signature.h>
 #include "rough_symbol_sync_cc_impl.h"
-
-#include <fftw3.h>
-#include <volk/volk.h>
+#include "cp_correlator.h"
 
 #include <cstdio>
+#include <cmath>
 
 namespace gr {
   namespace lte {
@@ -40,6 +39,9 @@ namespace gr {
         (new rough_symbol_sync_cc_impl(fftl, vlen, name));
     }
 
+    const float rough_symbol_sync_cc_impl::d_RHO = 10.0f/11.0f;
+    const float rough_symbol_sync_cc_impl::d_ALPHA = 0.1f;
+
     /*
      * The private constructor
      */
@@ -52,16 +54,22 @@ namespace gr {
                 d_cpl0(160*fftl/2048),
                 d_slotl(7*fftl+6*d_cpl+d_cpl0),
                 d_sym_pos(0),
-                d_corr_val(0.0),
+                d_frac_cfo(0.0),
+                d_valid(false),
                 d_work_call(0),
-		d_vlen(vlen)
+		d_vlen(vlen),
+                d_gamma(0.0),
+                d_phi(0.0),
+                d_gamma_av(d_slotl),
+                d_phi_av(d_slotl)
     {
         d_key=pmt::string_to_symbol("symbol");
+        d_cfo_key=pmt::string_to_symbol("frac_cfo");
         d_tag_id=pmt::string_to_symbol(this->name() );
 
-        d_cp0 = (gr_complex*)fftwf_malloc(sizeof(gr_complex)*d_cpl0*d_vlen);
-        d_cp1 = (gr_complex*)fftwf_malloc(sizeof(gr_complex)*d_cpl0*d_vlen);
-        d_res = (gr_complex*)fftwf_malloc(sizeof(gr_complex)*d_cpl0*d_vlen);
+        //in[0] is the sample before the current window, the newest sample
+        //of the window is d_fftl+d_cpl items later
+        set_history(d_fftl+d_cpl+1);
     }
 
     /*
@@ -69,33 +77,8 @@ namespace gr {
      */
     rough_symbol_sync_cc_impl::~rough_symbol_sync_cc_impl()
     {
-        fftwf_free(d_cp0);
-        fftwf_free(d_cp1);
-        fftwf_free(d_res);
-    }
-
-
-
-
-    void rough_symbol_sync_cc_impl::forecast(int noutput_items, 
-				gr_vector_int &ninput_items_required)
-    {
-	//more than fftl+stp input items are required for correlation (standart too small)
-	//maybe block before cp-sync requires bigger output buffer
-
-       
-	//~16*4 correlations in work function
-	if(noutput_items< d_fftl+d_cpl*16){
-	    ninput_items_required[0]=d_fftl+d_cpl*16;
-	}
-	else
-	{
-	    ninput_items_required[0]=noutput_items;
-	}
     }
 
-
-
     int
     rough_symbol_sync_cc_impl::work(int noutput_items,
 			  gr_vector_const_void_star &input_items,
@@ -104,96 +87,74 @@ namespace gr {
         const gr_complex *in = (const gr_complex *) input_items[0];
         gr_complex *out = (gr_complex *) output_items[0];
 
-        //printf("%s.work\tnoutput_items = %i\tnitems_read = %ld\n", name().c_str(), noutput_items, nitems_read(0) );
-
-        if(nitems_read(0) > 100000){
-            add_item_tag(0,nitems_read(0)+5,d_key, pmt::from_long(d_sym_pos),d_tag_id);
-            d_work_call++;
-            memcpy(out,in,sizeof(gr_complex)*noutput_items*d_vlen );
-            return noutput_items;
-        }
-
-        int stp = d_cpl0/4;
-        int nout = 0;
-
-        int coarse_pos = 0;
-        gr_complex it_val = 0;
+        const int vlen = d_vlen;
+        const int lag = d_fftl*vlen;
+        const long nir = nitems_read(0);
 
-        for(int i = 0; i < d_cpl*15-stp; i+=stp){  
-      //for(int i = 0; i < d_fftl+d_cpl*16 - (d_fftl+d_cpl+stp); i+=stp){
+        //van de Beek: gamma(m) = SUM r(k)r*(k+fftl), phi(m) = 1/2 SUM |r(k)|^2+|r(k+fftl)|^2
+        //over the window k = m ... m+cpl-1, moved by one sample per output item
+        for(int i = 0; i < noutput_items; i++){
+            const gr_complex* x = in + i*vlen;
+            long m = nir + i - d_fftl - d_cpl + 1;
+            int pos = int(((m % d_slotl) + d_slotl) % d_slotl);
 
-            memcpy(d_cp0,in+i*d_vlen          ,sizeof(gr_complex)*d_cpl*d_vlen);
-            memcpy(d_cp1,in+(i+d_fftl)*d_vlen ,sizeof(gr_complex)*d_cpl*d_vlen);
-            gr_complex val = corr(d_res,d_cp0,d_cp1,d_cpl*d_vlen);
-
-            if(abs(it_val) < abs(val) ){
-                coarse_pos = i;
-                if(d_corr_val < abs(val) ){
-                    d_corr_val = abs(val);
-                    d_sym_pos = (nitems_read(0) + coarse_pos)%d_slotl;
-                  //printf("%s %i\tNEW coarse max!\tval = %f\tcoarse_pos = %i\t",name().c_str(), d_work_call, abs(val), coarse_pos );
-                  //printf("corr_val = %f\tsym_pos = %ld\n", d_corr_val, d_sym_pos);
+            if(pos == 0){
+                reseed(x + vlen);
+            }
+            else{
+                const gr_complex* xe = x + d_cpl*vlen;
+                for(int v = 0; v < vlen; v++){
+                    d_gamma += xe[v]*conj(xe[v+lag]) - x[v]*conj(x[v+lag]);
+                    d_phi += 0.5f*(norm(xe[v]) + norm(xe[v+lag]) - norm(x[v]) - norm(x[v+lag]));
                 }
-                it_val = val;
             }
-            //if(nitems_read(0) < 10000){
-            //    printf("%s\tcorr_val = %f\tnitems_read = %ld\n", name().c_str(), abs(val), nitems_read(0) );
-            //}
-            nout = i;
-        }
 
-        if(nout > 0){
-            if(coarse_pos < stp){
-                coarse_pos = stp;
-            }
-            int fine_pos = coarse_pos;
-            for(int i = coarse_pos-stp ; i < coarse_pos+stp; i++){
-                memcpy(d_cp0,in+i*d_vlen         ,sizeof(gr_complex)*d_cpl*d_vlen);
-                memcpy(d_cp1,in+(i+d_fftl)*d_vlen,sizeof(gr_complex)*d_cpl*d_vlen);
-                gr_complex val = corr(d_res,d_cp0,d_cp1,d_cpl*d_vlen);
-
-                if(abs(it_val) < abs(val) ){
-                    fine_pos = i;
-                    if(d_corr_val < abs(val) ){
-                        d_corr_val = abs(val);
-                        long abs_pos = nitems_read(0) + fine_pos;
-                        d_sym_pos = (nitems_read(0) + fine_pos)%d_slotl;
-                        //printf("%s\tfine corr sym_pos = %ld\n",name().c_str(), d_sym_pos );
-                        //printf("corr_val = %f\tsym_pos = %ld\tabs_pos = %ld\n", d_corr_val, d_sym_pos, abs_pos);
-                    }
-                }
+            d_gamma_av[pos] += d_ALPHA*(d_gamma - d_gamma_av[pos]);
+            d_phi_av[pos] += d_ALPHA*(d_phi - d_phi_av[pos]);
+            if(pos == d_slotl-1){
+                update_estimate();
+                d_valid = m >= d_slotl-1;
             }
         }
 
-        //The next if-statement exists for the sole purpose to avoid an infinity loop caused by the scheduler and not enough input items.
-        if(nout == 0){
-            printf("%s\tnout = %i\tnoutput_items = %i\tnitems_read = %ld\titems dumped!\n",name().c_str(), nout, noutput_items, nitems_read(0) );
-            nout = noutput_items;
-        }
+        memcpy(out, in+(d_fftl+d_cpl)*vlen, sizeof(gr_complex)*noutput_items*vlen );
 
         // actually the next block doesn't care about the exact tag position. Only the value and key are important.
-        memcpy(out, in, sizeof(gr_complex)*nout*d_vlen );
-        add_item_tag(0,nitems_read(0)+5,d_key, pmt::from_long(d_sym_pos),d_tag_id);
+        // no tags before the first slot is complete, the estimate would be made from the zero history.
+        if(d_valid){
+            add_item_tag(0,nitems_read(0)+5,d_key, pmt::from_long(d_sym_pos),d_tag_id);
+            add_item_tag(0,nitems_read(0)+5,d_cfo_key, pmt::from_double(d_frac_cfo),d_tag_id);
+        }
         d_work_call++;
         // Tell runtime system how many output items we produced.
-        return nout;
+        return noutput_items;
     }
-    
-    gr_complex
-    rough_symbol_sync_cc_impl::corr(gr_complex *res, gr_complex *x, gr_complex *y, int len)
+
+    //recalculate the moving sums once per slot to limit rounding errors
+    void
+    rough_symbol_sync_cc_impl::reseed(const gr_complex* x)
     {
-        volk_32fc_conjugate_32fc_a(y, y, len);
-        volk_32fc_x2_multiply_32fc_a(res, x, y, len);
-
-        float* i_vector = (float*)fftwf_malloc(sizeof(float)*len);
-        float* q_vector = (float*)fftwf_malloc(sizeof(float)*len);
-        volk_32fc_deinterleave_32f_x2_a(i_vector, q_vector, res, len);
-        float i_result = 0.0f;
-        float q_result = 0.0f;
-        volk_32f_accumulator_s32f_a(&i_result, i_vector, len);
-        volk_32f_accumulator_s32f_a(&q_result, q_vector, len);
-
-        return gr_complex(i_result, q_result);
+        const int len = d_cpl*d_vlen;
+        const gr_complex* y = x + d_fftl*d_vlen;
+        d_gamma = cp_correlator::corr(x, y, len);
+        d_phi = 0.5f*(cp_correlator::corr(x, x, len).real() + cp_correlator::corr(y, y, len).real());
+    }
+
+    //ML symbol timing and fractional frequency offset (in subcarriers) of the averaged slot
+    void
+    rough_symbol_sync_cc_impl::update_estimate()
+    {
+        int pos = 0;
+        float max = abs(d_gamma_av[0]) - d_RHO*d_phi_av[0];
+        for(int p = 1; p < d_slotl; p++){
+            float val = abs(d_gamma_av[p]) - d_RHO*d_phi_av[p];
+            if(val > max){
+                max = val;
+                pos = p;
+            }
+        }
+        d_sym_pos = pos;
+        d_frac_cfo = -arg(d_gamma_av[pos])/(2*M_PI);
     }
 
   } /* namespace lte */
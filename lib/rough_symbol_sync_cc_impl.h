@@ -22,6 +22,7 @@
 #define INCLUDED_LTE_ROUGH_SYMBOL_SYNC_CC_IMPL_H
 
 #include <lte/rough_symbol_sync_cc.h>
+#include <vector>
 
 namespace gr {
   namespace lte {
@@ -29,31 +30,40 @@ namespace gr {
     class rough_symbol_sync_cc_impl : public rough_symbol_sync_cc
     {
      private:
+        // rho = SNR/(SNR+1) of the ML metric, set for 10dB
+        static const float d_RHO;
+        // weight of a new slot in the averaged correlation
+        static const float d_ALPHA;
+
         int d_fftl;
         int d_cpl;
         int d_cpl0;
         int d_slotl;
         long d_sym_pos;
-        float d_corr_val;
+        float d_frac_cfo;
+        // set once a whole slot of input went into the estimate
+        bool d_valid;
         int d_work_call;
 	int d_vlen;
-        gr_complex* d_cp0;
-        gr_complex* d_cp1;
-        gr_complex* d_res;
+
+        // CP correlation and energy of the current window, updated per sample
+        gr_complex d_gamma;
+        float d_phi;
+        // both averaged over slots, one value per position in slot
+        std::vector<gr_complex> d_gamma_av;
+        std::vector<float> d_phi_av;
         
         pmt::pmt_t d_key;
+        pmt::pmt_t d_cfo_key;
         pmt::pmt_t d_tag_id;
-        
-        gr_complex corr(gr_complex *x,gr_complex *y, int len);
-        gr_complex corr(gr_complex *res, gr_complex *x, gr_complex *y, int len);
+
+        void reseed(const gr_complex* x);
+        void update_estimate();
 
      public:
       rough_symbol_sync_cc_impl(int fftl, int vlen, std::string& name);
       ~rough_symbol_sync_cc_impl();
 
-      void forecast(int noutput_items, 
-	       gr_vector_int &ninput_items_required);
-
       // Where all the action really happens
       int work(int noutput_items,
 	       gr_vector_const_void_star &input_items,
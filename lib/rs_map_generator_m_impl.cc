@@ -0,0 +1,171 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "rs_map_generator_m_impl.h"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace gr {
+  namespace lte {
+
+    rs_map_generator_m::sptr
+    rs_map_generator_m::make(std::string msg_buf_name_in,
+                             std::string msg_buf_name_out, int N_rb_dl,
+                             int ant_port, std::string name)
+    {
+      return gnuradio::get_initial_sptr(
+          new rs_map_generator_m_impl(msg_buf_name_in, msg_buf_name_out,
+                                      N_rb_dl, ant_port, name));
+    }
+
+    /*
+     * The private constructor
+     */
+    rs_map_generator_m_impl::rs_map_generator_m_impl(
+        std::string msg_buf_name_in, std::string msg_buf_name_out,
+        int N_rb_dl, int ant_port, std::string name) :
+        gr::block(name, gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)), d_N_rb_dl(N_rb_dl), d_ant_port(
+            ant_port), d_cell_id(-1), d_cache(d_N_CELL_IDS, pmt::PMT_NIL)
+    {
+      if(N_rb_dl < 6 || N_rb_dl > d_N_RB_MAX){
+        throw std::invalid_argument("rs_map_generator_m: N_rb_dl must be in [6, 110]");
+      }
+      if(ant_port < 0 || ant_port > 3){
+        throw std::invalid_argument("rs_map_generator_m: ant_port must be in [0, 3]");
+      }
+      d_pn_seq.resize(4 * d_N_RB_MAX);
+
+      d_port_in = pmt::mp(msg_buf_name_in);
+      d_port_out = pmt::mp(msg_buf_name_out);
+      message_port_register_in(d_port_in);
+      set_msg_handler(d_port_in,
+                      boost::bind(&rs_map_generator_m_impl::handle_msg, this, _1));
+      message_port_register_out(d_port_out);
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    rs_map_generator_m_impl::~rs_map_generator_m_impl()
+    {
+    }
+
+    void
+    rs_map_generator_m_impl::handle_msg(pmt::pmt_t msg)
+    {
+      int cell_id = int(pmt::to_long(msg));
+      if(cell_id == d_cell_id){
+        return;
+      }
+      if(cell_id < 0 || cell_id >= d_N_CELL_IDS){
+        printf("%s invalid cell_id = %i\n", name().c_str(), cell_id);
+        return;
+      }
+      d_cell_id = cell_id;
+      printf("%s cell_id = %i generating RS map!\n", name().c_str(), cell_id);
+      message_port_pub(d_port_out, pilot_map(cell_id));
+    }
+
+    pmt::pmt_t
+    rs_map_generator_m_impl::pilot_map(int cell_id)
+    {
+      if(cell_id < 0 || cell_id >= d_N_CELL_IDS){
+        throw std::invalid_argument("rs_map_generator_m: cell_id must be in [0, 503]");
+      }
+      gr::thread::scoped_lock lock(d_mutex);
+      if(pmt::is_null(d_cache[cell_id])){
+        d_cache[cell_id] = generate_pilot_map(cell_id);
+      }
+      return d_cache[cell_id];
+    }
+
+    void
+    rs_map_generator_m_impl::precompute_pilot_maps()
+    {
+      for(int cell_id = 0; cell_id < d_N_CELL_IDS; cell_id++){
+        pilot_map(cell_id);
+      }
+    }
+
+    pmt::pmt_t
+    rs_map_generator_m_impl::generate_pilot_map(int cell_id)
+    {
+      d_offsets.assign(1, 0);
+      d_positions.clear();
+      d_values.clear();
+      for(int ns = 0; ns < d_N_SLOTS; ns++){
+        for(int l = 0; l < d_N_DL_SYMB; l++){
+          // antenna ports 0 and 1 use symbols 0 and 4, ports 2 and 3 symbol 1.
+          bool has_rs = d_ant_port < 2 ? (l == 0 || l == 4) : l == 1;
+          if(has_rs){
+            add_symbol_pilots(cell_id, ns, l);
+          }
+          d_offsets.push_back(d_positions.size());
+        }
+      }
+      return pmt::list3(
+          pmt::init_s32vector(d_offsets.size(), &d_offsets[0]),
+          pmt::init_s32vector(d_positions.size(), &d_positions[0]),
+          pmt::init_c32vector(d_values.size(), &d_values[0]));
+    }
+
+    // 36.211 6.10.1.1 and 6.10.1.2
+    void
+    rs_map_generator_m_impl::add_symbol_pilots(int cell_id, int ns, int l)
+    {
+      const float amp = 1.0f / std::sqrt(2.0f);
+      unsigned int c_init = 1024 * (7 * (ns + 1) + l + 1) * (2 * cell_id + 1)
+          + 2 * cell_id + d_N_CP;
+      int m_off = d_N_RB_MAX - d_N_rb_dl;
+      int seq_len = 2 * (m_off + 2 * d_N_rb_dl);
+      d_gold.init(c_init);
+      d_gold.generate_bits(&d_pn_seq[0], seq_len);
+
+      int offset = (calc_v(ns, l) + (cell_id % 6)) % 6;
+      for(int m = 0; m < 2 * d_N_rb_dl; m++){
+        int mp = m + m_off;
+        d_positions.push_back(offset + 6 * m);
+        d_values.push_back(
+            gr_complex(amp * (1 - 2 * d_pn_seq[2 * mp]),
+                       amp * (1 - 2 * d_pn_seq[2 * mp + 1])));
+      }
+    }
+
+    int
+    rs_map_generator_m_impl::calc_v(int ns, int l)
+    {
+      switch(d_ant_port){
+        case 0: return l == 0 ? 0 : 3;
+        case 1: return l == 0 ? 3 : 0;
+        case 2: return 3 * (ns % 2);
+        default: return 3 + 3 * (ns % 2);
+      }
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
@@ -0,0 +1,76 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_RS_MAP_GENERATOR_M_IMPL_H
+#define INCLUDED_LTE_RS_MAP_GENERATOR_M_IMPL_H
+
+#include <lte/rs_map_generator_m.h>
+#include <lte/gold_sequence.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/thread/thread.h>
+#include <vector>
+
+namespace gr {
+  namespace lte {
+
+    class rs_map_generator_m_impl : public rs_map_generator_m
+    {
+     private:
+      static const int d_N_RB_MAX = 110;
+      static const int d_N_CELL_IDS = 504;
+      static const int d_N_SLOTS = 20;
+      static const int d_N_DL_SYMB = 7;
+      static const int d_N_CP = 1;
+
+      int d_N_rb_dl;
+      int d_ant_port;
+      int d_cell_id;
+      pmt::pmt_t d_port_in;
+      pmt::pmt_t d_port_out;
+
+      // one pilot map message per cell ID, PMT_NIL if not calculated yet.
+      std::vector<pmt::pmt_t> d_cache;
+      gr::thread::mutex d_mutex;
+
+      gold_sequence d_gold;
+      std::vector<char> d_pn_seq;
+      std::vector<int> d_offsets;
+      std::vector<int> d_positions;
+      std::vector<gr_complex> d_values;
+
+      void handle_msg(pmt::pmt_t msg);
+      pmt::pmt_t generate_pilot_map(int cell_id);
+      void add_symbol_pilots(int cell_id, int ns, int l);
+      int calc_v(int ns, int l);
+
+     public:
+      rs_map_generator_m_impl(std::string msg_buf_name_in,
+                              std::string msg_buf_name_out, int N_rb_dl,
+                              int ant_port, std::string name);
+      ~rs_map_generator_m_impl();
+
+      pmt::pmt_t pilot_map(int cell_id);
+      void precompute_pilot_maps();
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_RS_MAP_GENERATOR_M_IMPL_H */
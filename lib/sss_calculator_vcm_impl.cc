@@ -74,23 +74,6 @@ namespace gr {
             d_cX[i] = 1-2*cX_x[i];
         }
 
-        //initialize d_sref
-        int m0_ref=0;
-        char sX_x[31]={0};
-        sX_x[4]=1;
-        for(int i = 0; i < 26 ; i++){
-            sX_x[i+5] = (sX_x[i+2] + sX_x[i])%2;
-        }
-        gr_complex sX[31]={0};
-        for(int i = 0 ; i < 31 ; i++){
-            sX[i] = 1-2*sX_x[i];
-        }
-        int m0 = 0;
-        for(int i = 0 ; i < 31 ; i++){
-            d_sref[i   ]=sX[ (i+m0)%31 ];
-            d_sref[i+31]=sX[ (i+m0)%31 ];
-        }
-
         //initialize d_zX
         char zX_x[31] = {0};
         zX_x[4] = 1;
@@ -100,18 +83,6 @@ namespace gr {
         for (int i = 0; i < 31 ; i++){
             d_zX[i] = 1 - (2*zX_x[i]);
         }
-
-        //initialize m0/m1 pair lookup table
-        for(int i = 0 ; i < 168 ; i++){
-            int N = i;
-            int q_prime = floor(N/30);
-            int q = floor( ( N + (q_prime*(q_prime+1)/2) )/30 );
-            int m_prime = N + q * (q+1)/2;
-            int m0g = m_prime%31;
-            int m1g = (m0g + int(floor(m_prime/31))+1 )%31;
-            d_v_m0[i] = m0g;
-            d_v_m1[i] = m1g;
-        }
     }
 
     /*
@@ -226,75 +197,28 @@ namespace gr {
     int
     sss_calculator_vcm_impl::get_N_id_1(int m0, int m1)
     {
-        int N_id_1 = -1;
-        for(int i = 0 ; i < 168 ; i++ ){
-            if(d_v_m0[i] == m0 && d_v_m1[i] == m1){
-                N_id_1 = i;
-                break;
-            }
-        }
-        return N_id_1;
+        return d_sss.N_id_1(m0, m1);
     }
 
     int
     sss_calculator_vcm_impl::calc_m(gr_complex *s0m0)
     {
-        int mX = -1;
-        int N = 62;
-
-        gr_complex s0[62] = {0};
-        memcpy(s0, s0m0, sizeof(gr_complex) * 31);
-        
-        gr_complex sr[62] = {0};
-        memcpy(sr, d_sref, sizeof(gr_complex) * 62);
-        
-        std::vector<gr_complex> x_vec;
-        xcorr(x_vec, s0, sr, N);
-
-        float max = 0;
-        int pos = -1;
-        for (int i = 0 ; i < 2*N-1 ; i++){
-            float mag = abs(x_vec[i]);
-            if (max < mag){
-                max = mag;
-                pos = i;
+        // correlation with all 31 cyclic shifts of s~
+        float metric[31] = {0};
+        d_sss.add_shift_metrics(metric, s0m0);
+
+        int mX = 0;
+        for(int m = 1; m < 31; m++){
+            if(metric[m] > metric[mX]){
+                mX = m;
             }
         }
 
-        mX = abs(pos-31-31);
-
-        d_max_val_new = (d_max_val_new + max)/2;
+        d_max_val_new = (d_max_val_new + metric[mX])/2;
 
         return mX;
     }
 
-    // simple correlation between 2 arrays. returns complex value.
-    gr_complex
-    sss_calculator_vcm_impl::corr(gr_complex *x,gr_complex *y, int len)
-    {
-        gr_complex val = 0;
-        for(int i = 0 ; i < len ; i++){
-            val += (x[i]*conj(y[i]) );
-        }
-        return val;
-    }
-
-    // be careful! input arrays must have the same size!
-    void
-    sss_calculator_vcm_impl::xcorr(std::vector<gr_complex> &v, gr_complex *x,gr_complex *y, int len)
-    {
-        int N = len;
-
-        for (int i = 0 ; i < 2 * N - 1 ; i++){
-            if(i < N){
-                v.push_back( corr(x+(N-1-i),y,i+1) );
-            }
-            else{
-                v.push_back( corr(x,y+(i-N),2*N-1-i) );
-            }
-        }
-    }
-    
     void
     sss_calculator_vcm_impl::publish_cell_id(int cell_id)
     {
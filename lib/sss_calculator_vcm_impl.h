@@ -22,6 +22,7 @@
 #define INCLUDED_LTE_SSS_CALCULATOR_VCM_IMPL_H
 
 #include <lte/sss_calculator_vcm.h>
+#include "sss_detector.h"
 
 namespace gr {
   namespace lte {
@@ -39,10 +40,8 @@ namespace gr {
         int d_fftl;
         int d_slotl;
         char d_cX[31];
-        gr_complex d_sref[62];
         char d_zX[31];
-        int d_v_m0[168];
-        int d_v_m1[168];
+        sss_detector d_sss;
         float d_max_val_new;
         float d_max_val_old;
         int d_sss_pos;
@@ -56,8 +55,6 @@ namespace gr {
         int calc_m(gr_complex *s0m0);
         int get_N_id_1(int m0, int m1);
         sss_info get_sss_info(gr_complex* even, gr_complex* odd, int N_id_2);
-        gr_complex corr(gr_complex *x,gr_complex *y, int len);
-        void xcorr(std::vector<gr_complex> &v, gr_complex *x,gr_complex *y, int len);
 
         pmt::pmt_t d_port_cell_id;
         pmt::pmt_t d_port_frame_start;
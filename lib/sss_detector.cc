@@ -0,0 +1,198 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "sss_detector.h"
+#include <cmath>
+
+namespace gr {
+  namespace lte {
+
+    sss_detector::sss_detector()
+    {
+      // s~ = x(i) with x(i+5) = (x(i+2) + x(i)) mod 2, x(4) = 1
+      char x[35] = {0};
+      x[4] = 1;
+      for(int i = 0; i < 30; i++){
+        x[i+5] = (x[i+2] + x[i]) % 2;
+      }
+
+      // state of index n holds x(n) ... x(n+4) in bits 0 ... 4
+      for(int n = 0; n < 31; n++){
+        int state = 0;
+        for(int j = 0; j < 5; j++){
+          state |= x[n+j] << j;
+        }
+        d_state[n] = state;
+        d_s[n] = 1 - 2 * x[n];
+      }
+
+      // x(n+m) = parity(state(n) & d_walsh[m]), the masks obey the recurrence of x
+      int mask[31];
+      for(int m = 0; m < 5; m++){
+        mask[m] = 1 << m;
+      }
+      for(int m = 5; m < 31; m++){
+        mask[m] = mask[m-3] ^ mask[m-5];
+      }
+      for(int m = 0; m < 31; m++){
+        d_walsh[m] = mask[m];
+      }
+
+      // c~: x(i+5) = (x(i+3) + x(i)) mod 2, z~: x(i+5) = (x(i+4) + x(i+2) + x(i+1) + x(i)) mod 2
+      char xc[31] = {0};
+      char xz[31] = {0};
+      xc[4] = xz[4] = 1;
+      for(int i = 0; i < 26; i++){
+        xc[i+5] = (xc[i+3] + xc[i]) % 2;
+        xz[i+5] = (xz[i+4] + xz[i+2] + xz[i+1] + xz[i]) % 2;
+      }
+      for(int i = 0; i < 31; i++){
+        d_c[i] = 1 - 2 * xc[i];
+        d_z[i] = 1 - 2 * xz[i];
+      }
+
+      for(int m0 = 0; m0 < 31; m0++){
+        for(int m1 = 0; m1 < 31; m1++){
+          d_N_id_1[m0][m1] = -1;
+        }
+      }
+      for(int N = 0; N < 168; N++){
+        int q_prime = N / 30;
+        int q = (N + q_prime * (q_prime + 1) / 2) / 30;
+        int m_prime = N + q * (q + 1) / 2;
+        int m0 = m_prime % 31;
+        int m1 = (m0 + m_prime / 31 + 1) % 31;
+        d_N_id_1[m0][m1] = N;
+        d_m[N][0] = m0;
+        d_m[N][1] = m1;
+      }
+    }
+
+    void
+    sss_detector::add_shift_metrics(float* metric, const gr_complex* x) const
+    {
+      gr_complex corr[31];
+      shift_corr(corr, x);
+      for(int m = 0; m < 31; m++){
+        metric[m] += std::abs(corr[m]);
+      }
+    }
+
+    void
+    sss_detector::shift_corr(gr_complex* corr, const gr_complex* x) const
+    {
+      // index 0 is the all zero state which does not occur in an m-sequence
+      gr_complex y[32];
+      y[0] = gr_complex(0.0f, 0.0f);
+      for(int n = 0; n < 31; n++){
+        y[d_state[n]] = x[n];
+      }
+
+      for(int h = 1; h < 32; h <<= 1){
+        for(int i = 0; i < 32; i += 2 * h){
+          for(int j = i; j < i + h; j++){
+            const gr_complex a = y[j];
+            const gr_complex b = y[j+h];
+            y[j] = a + b;
+            y[j+h] = a - b;
+          }
+        }
+      }
+
+      for(int m = 0; m < 31; m++){
+        corr[m] = y[d_walsh[m]];
+      }
+    }
+
+    int
+    sss_detector::decode(const gr_complex* a, const gr_complex* b, int N_id_2, int &parity, float &quality) const
+    {
+      // corr[v][0] holds the shifts of the even values of half frame v, which
+      // are s(m) * c0. The odd values are s(m) * c1 * z1(r) with r = m' mod 8
+      // of the other sequence, corr[v][1 + r] holds them for all 8 r.
+      gr_complex corr[2][9][31];
+      gr_complex x[31];
+      const gr_complex* d[2] = {a, b};
+      float energy = 0.0f;
+
+      for(int v = 0; v < 2; v++){
+        const gr_complex* dv = d[v];
+        for(int i = 0; i < 31; i++){
+          x[i] = d_c[(i + N_id_2) % 31] > 0 ? dv[2*i] : -dv[2*i];
+          energy += std::norm(dv[2*i]) + std::norm(dv[2*i+1]);
+        }
+        shift_corr(corr[v][0], x);
+
+        for(int r = 0; r < 8; r++){
+          for(int i = 0; i < 31; i++){
+            char sign = d_c[(i + N_id_2 + 3) % 31] * d_z[(i + r) % 31];
+            x[i] = sign > 0 ? dv[2*i+1] : -dv[2*i+1];
+          }
+          shift_corr(corr[v][1 + r], x);
+        }
+      }
+
+      // subframe 0 is s0(m0) c0, s1(m1) c1 z1(m0), subframe 5 is s1(m1) c0, s0(m0) c1 z1(m1)
+      int best = -1;
+      float best_metric = 0.0f;
+      for(int N = 0; N < 168; N++){
+        const int m0 = d_m[N][0];
+        const int m1 = d_m[N][1];
+        const gr_complex sf0_sf5 = corr[0][0][m0] + corr[0][1 + m0 % 8][m1]
+                                 + corr[1][0][m1] + corr[1][1 + m1 % 8][m0];
+        const gr_complex sf5_sf0 = corr[0][0][m1] + corr[0][1 + m1 % 8][m0]
+                                 + corr[1][0][m0] + corr[1][1 + m0 % 8][m1];
+        if(best < 0 || sf0_sf5.real() > best_metric){
+          best = N;
+          best_metric = sf0_sf5.real();
+          parity = 0;
+        }
+        if(sf5_sf0.real() > best_metric){
+          best = N;
+          best_metric = sf5_sf0.real();
+          parity = 1;
+        }
+      }
+
+      // each real correlation value has variance energy / 2 for noise
+      quality = energy > 0.0f ? best_metric / std::sqrt(0.5f * energy) : 0.0f;
+      return best;
+    }
+
+    void
+    sss_detector::sequence(float* d, int N_id_1, int N_id_2, int subframe) const
+    {
+      const int m0 = d_m[N_id_1][0];
+      const int m1 = d_m[N_id_1][1];
+      const int ma = subframe == 0 ? m0 : m1;
+      const int mb = subframe == 0 ? m1 : m0;
+      for(int n = 0; n < 31; n++){
+        d[2*n] = d_s[(n + ma) % 31] * d_c[(n + N_id_2) % 31];
+        d[2*n+1] = d_s[(n + mb) % 31] * d_c[(n + N_id_2 + 3) % 31] * d_z[(n + ma % 8) % 31];
+      }
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
+
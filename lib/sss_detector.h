@@ -0,0 +1,90 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LTE_SSS_DETECTOR_H
+#define INCLUDED_LTE_SSS_DETECTOR_H
+
+#include <gnuradio/gr_complex.h>
+
+namespace gr {
+  namespace lte {
+
+    /*!
+     * \brief m-sequence detection for the SSS calculators
+     *
+     * add_shift_metrics() correlates 31 values with all 31 cyclic shifts of
+     * the SSS m-sequence s~ at once. A shifted m-sequence is a Walsh
+     * function of the shift register state, thus one 32 point fast Hadamard
+     * transform of x, scattered by the state of each index, yields all
+     * shifts. N_id_1() is the inverse of the (m0, m1) mapping of
+     * 3GPP TS 36.211 6.11.2.1 as a lookup table. decode() tests all 168
+     * N_id_1 and both subframe orders against the equalized SSS of two
+     * consecutive half frames.
+     */
+    class sss_detector
+    {
+    public:
+      sss_detector();
+
+      // metric[m] += |SUM_n x[n] * s~((n + m) mod 31)| for m in [0, 31)
+      void add_shift_metrics(float* metric, const gr_complex* x) const;
+
+      // N_id_1 of the pair m0 < m1, -1 if there is none
+      int N_id_1(int m0, int m1) const
+      {
+        if(m0 < 0 || m0 > 30 || m1 < 0 || m1 > 30){
+          return -1;
+        }
+        return d_N_id_1[m0][m1];
+      }
+
+      // Most likely N_id_1 of the equalized SSS values a and b of two
+      // consecutive half frames, 62 each. Equalized values are real, the
+      // metric is the real part of the correlation with all four SSS halves.
+      // parity is 0 if a is subframe 0 and 1 if a is subframe 5. A missing
+      // half frame may be all zeros. quality is the metric divided by its
+      // standard deviation for noise.
+      int decode(const gr_complex* a, const gr_complex* b, int N_id_2, int &parity, float &quality) const;
+
+      // NRZ coded SSS d(0) ... d(61) of subframe 0 or 5
+      void sequence(float* d, int N_id_1, int N_id_2, int subframe) const;
+
+    private:
+      // NRZ coded m-sequence s~ and scrambling sequences c~ and z~
+      char d_s[31];
+      char d_c[31];
+      char d_z[31];
+      // Hadamard input index of x[n]: shift register state of s~ at n
+      unsigned char d_state[31];
+      // Hadamard output index of cyclic shift m
+      unsigned char d_walsh[31];
+      short d_N_id_1[31][31];
+      // (m0, m1) of N_id_1
+      unsigned char d_m[168][2];
+
+      // corr[m] = SUM_n x[n] * s~((n + m) mod 31)
+      void shift_corr(gr_complex* corr, const gr_complex* x) const;
+    };
+
+  } // namespace lte
+} // namespace gr
+
+#endif /* INCLUDED_LTE_SSS_DETECTOR_H */
+
@@ -24,8 +24,8 @@
 
 #include <gnuradio/io_signature.h>
 #include "sync_frequency_c_impl.h"
+#include "cp_correlator.h"
 #include <fftw3.h>
-#include <volk/volk.h>
 #include <cmath>
 
 namespace gr {
@@ -57,6 +57,9 @@ namespace gr {
                 d_offset(0)
     {
         d_buffer = (gr_complex*)fftwf_malloc(sizeof(gr_complex)*d_slotl);
+
+        d_port_freq = pmt::string_to_symbol("freq");
+        message_port_register_out(d_port_freq);
     }
 
     /*
@@ -128,17 +131,13 @@ namespace gr {
         int fftl = d_fftl;
         int cpl = d_cpl;
         int cpl0 = d_cpl0;
-        gr_complex *res = (gr_complex*)fftwf_malloc(sizeof(gr_complex)*cpl0);
 
         //printf("%s.calc_f_off_av\n", name().c_str() );
 
-        // The next few lines are predestined for volk usage / performance improvements.
+        //CP of each symbol correlated with the end of the symbol
         gr_complex corr_val[7] = {0};
-        corr_val[0] = corr (res, d_buffer, d_buffer+cpl0, cpl0);
-
-        for(int i = 0 ; i < 6; i++){
-            corr_val[i+1] = corr(res, d_buffer+fftl+cpl0+i*(fftl+cpl), d_buffer+fftl+cpl0+i*(fftl+cpl)+fftl, cpl );
-        }
+        corr_val[0] = cp_correlator::corr(d_buffer, d_buffer+fftl, cpl0);
+        cp_correlator::sliding_corr(corr_val+1, d_buffer+fftl+cpl0, fftl, cpl, fftl+cpl, 6);
 
         //find maximum correlation
         float max = abs(corr_val[0]);
@@ -160,28 +159,12 @@ namespace gr {
 
         //f_vec.push_back(d_f_av);
 
-        (*d_sig).set_frequency((-1)*double(d_f_av) );
-    }
-
-    gr_complex
-    sync_frequency_c_impl::corr(gr_complex *res, gr_complex *x, gr_complex *y, int len)
-    {
-        volk_32fc_conjugate_32fc_a(y, y, len);
-        volk_32fc_x2_multiply_32fc_a(res, x, y, len);
-
-        float* i_vector = (float*)fftwf_malloc(sizeof(float)*len);
-        float* q_vector = (float*)fftwf_malloc(sizeof(float)*len);
-        volk_32fc_deinterleave_32f_x2_a(i_vector, q_vector, res, len);
-        float i_result = 0.0f;
-        float q_result = 0.0f;
-        volk_32f_accumulator_s32f_a(&i_result, i_vector, len);
-        volk_32f_accumulator_s32f_a(&q_result, q_vector, len);
-
-        return gr_complex(i_result, q_result);
+        //offset to remove, for freq_rotator_cc
+        message_port_pub(d_port_freq, pmt::from_double(d_f_av));
+        if(d_sig)
+            (*d_sig).set_frequency((-1)*double(d_f_av) );
     }
 
-
-
   } /* namespace lte */
 } /* namespace gr */
 
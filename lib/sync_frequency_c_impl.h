@@ -38,6 +38,7 @@ namespace gr {
         int d_samp_rate;
         int d_offset;
         gr_complex* d_buffer;
+        pmt::pmt_t d_port_freq;
 
         float d_f_av;
         int d_samp_num;
@@ -46,8 +47,6 @@ namespace gr {
         //methods for further calculations
         void calc_f_off_av();
 
-        gr_complex corr(gr_complex *res, gr_complex *x, gr_complex *y, int len);
-
      public:
       sync_frequency_c_impl(boost::shared_ptr<gr::analog::sig_source_c> &sig, int fftl, std::string& name);
       ~sync_frequency_c_impl();
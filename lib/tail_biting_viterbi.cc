@@ -0,0 +1,249 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <lte/tail_biting_viterbi.h>
+
+#include <volk/volk.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace gr {
+  namespace lte {
+
+    // Generator polynomials 133, 171, 165 (octal) expressed as taps on
+    // w = (state << 1) | input. state bit 0 holds the most recent input bit.
+    static const int d_POLYS[tail_biting_viterbi::RATE] = { 0x6D, 0x4F, 0x57 };
+
+    tail_biting_viterbi::tail_biting_viterbi(int len) :
+        d_len(len), d_wrap_len(6 * (K - 1))
+    {
+      if(len < 1){
+        throw std::invalid_argument("tail_biting_viterbi: len must be positive");
+      }
+      int alig = volk_get_alignment();
+      d_metric = (float*) volk_malloc(sizeof(float) * N_STATES, alig);
+      d_metric_next = (float*) volk_malloc(sizeof(float) * N_STATES, alig);
+      d_branch = (float*) volk_malloc(sizeof(float) * N_STATES, alig);
+      d_sign = (float*) volk_malloc(sizeof(float) * RATE * N_STATES, alig);
+      d_decisions = (uint64_t*) volk_malloc(
+          sizeof(uint64_t) * (d_len + 2 * d_wrap_len), alig);
+      d_start_metric = (float*) volk_malloc(sizeof(float) * N_STATES, alig);
+      d_tb_bits = new char[d_len];
+      d_best_tb_bits = new char[d_len];
+      init_sign_table();
+    }
+
+    tail_biting_viterbi::~tail_biting_viterbi()
+    {
+      volk_free(d_metric);
+      volk_free(d_metric_next);
+      volk_free(d_branch);
+      volk_free(d_sign);
+      volk_free(d_decisions);
+      volk_free(d_start_metric);
+      delete[] d_tb_bits;
+      delete[] d_best_tb_bits;
+    }
+
+    void
+    tail_biting_viterbi::init_sign_table()
+    {
+      // All polynomials tap the oldest register bit. Thus the branch leaving
+      // the predecessor with this bit set has the inverted encoder output.
+      // Only the branch with this bit cleared needs to be stored.
+      for(int c = 0; c < RATE; c++){
+        for(int s = 0; s < N_STATES; s++){
+          int w = s & d_POLYS[c];
+          int parity = 0;
+          while(w){
+            parity ^= w & 1;
+            w >>= 1;
+          }
+          d_sign[c * N_STATES + s] = parity ? -1.0f : 1.0f;
+        }
+      }
+    }
+
+    void
+    tail_biting_viterbi::decode(char* out, const float* in)
+    {
+      // Extend trellis circularly. Decisions are only taken within the
+      // middle len steps, the wrap steps let the survivors converge.
+      int steps = d_len + 2 * d_wrap_len;
+      int first = (d_len - (d_wrap_len % d_len)) % d_len;
+
+      reset_metrics();
+      acs(d_decisions, in, first, steps);
+      traceback(out, d_decisions, best_state(), steps, d_wrap_len);
+    }
+
+    // Returns the number of trellis passes needed.
+    int
+    tail_biting_viterbi::decode_wava(char* out, const float* in, int max_iter)
+    {
+      reset_metrics();
+      bool found_tb = false;
+      float best_tb_metric = 0.0f;
+      int iter = 0;
+      while(iter < max_iter){
+        iter++;
+        memcpy(d_start_metric, d_metric, sizeof(float) * N_STATES);
+        acs(d_decisions, in, 0, d_len);
+        int end_state = best_state();
+        float end_metric = d_metric[end_state];
+        if(traceback(out, d_decisions, end_state, d_len, 0) == end_state){
+          return iter;
+        }
+
+        // Remember the best tail-biting survivor in case no pass terminates.
+        for(int s = 0; s < N_STATES; s++){
+          float metric = d_metric[s] - d_start_metric[s];
+          if(found_tb && metric <= best_tb_metric){
+            continue;
+          }
+          if(traceback(d_tb_bits, d_decisions, s, d_len, 0) == s){
+            found_tb = true;
+            best_tb_metric = metric;
+            memcpy(d_best_tb_bits, d_tb_bits, d_len);
+          }
+        }
+        // Next pass starts with the metrics of this one.
+        normalize_metrics(end_metric);
+      }
+      if(found_tb){
+        memcpy(out, d_best_tb_bits, d_len);
+      }
+      return iter;
+    }
+
+    void
+    tail_biting_viterbi::reset_metrics()
+    {
+      memset(d_metric, 0, sizeof(float) * N_STATES);
+    }
+
+    void
+    tail_biting_viterbi::normalize_metrics(float ref)
+    {
+      for(int s = 0; s < N_STATES; s++){
+        d_metric[s] -= ref;
+      }
+    }
+
+    void
+    tail_biting_viterbi::acs(uint64_t* decisions, const float* in, int first,
+                             int steps)
+    {
+      const int half = N_STATES / 2;
+      const float* sign0 = d_sign;
+      const float* sign1 = d_sign + N_STATES;
+      const float* sign2 = d_sign + 2 * N_STATES;
+      int bit = first;
+
+      for(int t = 0; t < steps; t++){
+        const float s0 = in[RATE * bit];
+        const float s1 = in[RATE * bit + 1];
+        const float s2 = in[RATE * bit + 2];
+        uint64_t dec = 0;
+
+#ifdef __SSE2__
+        const __m128 v0 = _mm_set1_ps(s0);
+        const __m128 v1 = _mm_set1_ps(s1);
+        const __m128 v2 = _mm_set1_ps(s2);
+        for(int s = 0; s < N_STATES; s += 4){
+          __m128 bm = _mm_mul_ps(v0, _mm_load_ps(sign0 + s));
+          bm = _mm_add_ps(bm, _mm_mul_ps(v1, _mm_load_ps(sign1 + s)));
+          bm = _mm_add_ps(bm, _mm_mul_ps(v2, _mm_load_ps(sign2 + s)));
+          _mm_store_ps(d_branch + s, bm);
+        }
+
+        // State ns is reached from ns >> 1 and (ns >> 1) + 32.
+        // Duplicating 4 predecessors yields 8 consecutive states.
+        for(int p = 0; p < half; p += 4){
+          const __m128 lo = _mm_load_ps(d_metric + p);
+          const __m128 hi = _mm_load_ps(d_metric + p + half);
+          for(int h = 0; h < 2; h++){
+            const int ns = 2 * p + 4 * h;
+            const __m128 a = h ? _mm_unpackhi_ps(lo, lo) : _mm_unpacklo_ps(lo, lo);
+            const __m128 b = h ? _mm_unpackhi_ps(hi, hi) : _mm_unpacklo_ps(hi, hi);
+            const __m128 bm = _mm_load_ps(d_branch + ns);
+            const __m128 m0 = _mm_add_ps(a, bm);
+            const __m128 m1 = _mm_sub_ps(b, bm);
+            _mm_store_ps(d_metric_next + ns, _mm_max_ps(m0, m1));
+            dec |= uint64_t(_mm_movemask_ps(_mm_cmpgt_ps(m1, m0))) << ns;
+          }
+        }
+#else
+        for(int s = 0; s < N_STATES; s++){
+          d_branch[s] = s0 * sign0[s] + s1 * sign1[s] + s2 * sign2[s];
+        }
+        for(int ns = 0; ns < N_STATES; ns++){
+          const float m0 = d_metric[ns >> 1] + d_branch[ns];
+          const float m1 = d_metric[(ns >> 1) + half] - d_branch[ns];
+          d_metric_next[ns] = m1 > m0 ? m1 : m0;
+          dec |= uint64_t(m1 > m0) << ns;
+        }
+#endif
+        decisions[t] = dec;
+        std::swap(d_metric, d_metric_next);
+        bit = (bit + 1 == d_len) ? 0 : bit + 1;
+      }
+    }
+
+    int
+    tail_biting_viterbi::best_state() const
+    {
+      int state = 0;
+      for(int s = 1; s < N_STATES; s++){
+        if(d_metric[s] > d_metric[state]){
+          state = s;
+        }
+      }
+      return state;
+    }
+
+    // Trace survivors back from state after the last step.
+    // Bits of steps [skip, skip + len) are written to out.
+    // Returns the state before the first step.
+    int
+    tail_biting_viterbi::traceback(char* out, const uint64_t* decisions,
+                                   int state, int steps, int skip)
+    {
+      for(int t = steps - 1; t >= 0; t--){
+        if(t >= skip && t < skip + d_len){
+          out[t - skip] = char(state & 1);
+        }
+        int oldest = int((decisions[t] >> state) & 1);
+        state = (state >> 1) | (oldest << (K - 2));
+      }
+      return state;
+    }
+
+  } /* namespace lte */
+} /* namespace gr */
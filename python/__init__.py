@@ -45,12 +45,9 @@ if _RTLD_GLOBAL != 0:
 from lte_swig import *
 
 # import any pure python here
-from bch_viterbi_vfvb import bch_viterbi_vfvb
+from bch_viterbi_trellis_vfvb import bch_viterbi_trellis_vfvb
 from utils import *
 from pbch_scramble_sequencer_m import pbch_scramble_sequencer_m
-from rs_map_generator_m import rs_map_generator_m
-
-from pcfich_scramble_sequencer_m import pcfich_scramble_sequencer_m
 #
 
 # ----------------------------------------------------------------
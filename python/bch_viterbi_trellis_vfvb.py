@@ -22,14 +22,15 @@
 from gnuradio import gr, blocks, trellis
 
 
-class bch_viterbi_vfvb(gr.hier_block2):
+class bch_viterbi_trellis_vfvb(gr.hier_block2):
     """
-    docstring for block bch_viterbi_vfvb
+    BCH Viterbi decoder built from gr-trellis blocks.
+    Kept as a reference for lte.bch_viterbi_vfvb which does the same in one block.
     """
 
     def __init__(self):
         gr.hier_block2.__init__(self,
-                                "bch_viterbi_vfvb",
+                                "bch_viterbi_trellis_vfvb",
                                 gr.io_signature(1, 1, gr.sizeof_float * 120), # Input signature
                                 gr.io_signature(1, 1, gr.sizeof_char * 40)) # Output signature
 
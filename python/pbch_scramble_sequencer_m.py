@@ -52,7 +52,7 @@ class pbch_scramble_sequencer_m(gr.sync_block):
 
         seqs = []
 
-        seq = lte.encode_nrz(lte.generate_pn_sequence(1920, cell_id))
+        seq = lte.gold_sequence.nrz(cell_id, 1920)
 
         pmt_list = pmt.list1(pmt.from_double(seq[0]))
         for i in range(len(seq) - 1):
@@ -20,8 +20,9 @@
 # 
 
 from gnuradio import gr, gr_unittest, blocks
-from bch_viterbi_vfvb import bch_viterbi_vfvb
+import lte_swig as lte
 import lte_test
+import random
 
 class qa_bch_viterbi_vfvb (gr_unittest.TestCase):
 
@@ -34,7 +35,7 @@ class qa_bch_viterbi_vfvb (gr_unittest.TestCase):
         data = lte_test.nrz_encoding(c_encoded)
 
         self.src = blocks.vector_source_f(data,False, 120)
-        self.vit = bch_viterbi_vfvb()
+        self.vit = lte.bch_viterbi_vfvb()
         self.snk = blocks.vector_sink_b(40)
         
         # connecting blocks
@@ -77,6 +78,62 @@ class qa_bch_viterbi_vfvb (gr_unittest.TestCase):
             self.assertEqual( [1] , [0] ) #throws always n error
         print "Viterbi decoder test END"
 
+    def test_002_noisy(self):
+        print "Viterbi decoder noisy input test"
+        random.seed(42)
+        test_range = 100
+
+        data = []
+        my_input = []
+        for sfn in range(test_range):
+            mib = lte_test.pack_mib(50, 0, 1.0, sfn % 1024)
+            mib_crc = lte_test.crc_checksum(mib, 2)
+            my_input.extend(mib_crc)
+            c_encoded = lte_test.convolutional_encoder(mib_crc)
+            nrz_encoded = lte_test.nrz_encoding(c_encoded)
+            data.extend([v + random.gauss(0.0, 0.5) for v in nrz_encoded])
+
+        self.src.set_data(data)
+        self.tb.run()
+
+        res = self.snk.data()
+        self.assertEqual(tuple(my_input), res)
+
+    def test_003_wava(self):
+        print "Viterbi decoder WAVA mode test"
+        random.seed(23)
+        test_range = 100
+        max_iter = 4
+
+        clean = []
+        noisy = []
+        my_input = []
+        for sfn in range(test_range):
+            mib = lte_test.pack_mib(50, 0, 1.0, sfn % 1024)
+            mib_crc = lte_test.crc_checksum(mib, 2)
+            my_input.extend(mib_crc)
+            c_encoded = lte_test.convolutional_encoder(mib_crc)
+            nrz_encoded = lte_test.nrz_encoding(c_encoded)
+            clean.extend(nrz_encoded)
+            noisy.extend([v + random.gauss(0.0, 0.5) for v in nrz_encoded])
+
+        for data in [clean, noisy]:
+            src = blocks.vector_source_f(data, False, 120)
+            vit = lte.bch_viterbi_vfvb(True, max_iter)
+            snk = blocks.vector_sink_b(40)
+            iter_snk = blocks.vector_sink_i()
+            tb = gr.top_block()
+            tb.connect(src, vit, snk)
+            tb.connect((vit, 1), iter_snk)
+            tb.run()
+
+            self.assertEqual(tuple(my_input), snk.data())
+            iters = iter_snk.data()
+            self.assertEqual(len(iters), test_range)
+            self.assertTrue(min(iters) >= 1 and max(iters) <= max_iter)
+            if data is clean:
+                self.assertEqual(iters, (1,) * test_range)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_bch_viterbi_vfvb, "qa_bch_viterbi_vfvb.xml")
@@ -0,0 +1,106 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# 
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+# 
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+from gnuradio import gr_unittest
+import lte_swig as lte
+import lte_test.lte_phy as t
+import numpy as np
+
+
+def sync_bins(fftlen):
+    # subcarriers -31 ... -1 and 1 ... 31
+    return np.array([c - 31 + fftlen if c < 31 else c - 30 for c in range(62)])
+
+
+def mod_frame(cell_id, fftlen, rng):
+    # 72 center subcarriers with random QPSK, PSS and SSS in slots 0 and 10
+    cp_len = t.lte_core.get_cp_length(fftlen)
+    ecp_len = t.lte_core.get_ecp_length(fftlen)
+    data_bins = np.array([k - 36 + fftlen if k < 36 else k - 35 for k in range(72)])
+    sss = t.get_sss(cell_id)
+    res = []
+    for sym in range(140):
+        spec = np.zeros(fftlen, dtype=complex)
+        spec[data_bins] = (rng.choice([-1, 1], 72) + 1j * rng.choice([-1, 1], 72)) / np.sqrt(2)
+        if sym in (5, 6, 75, 76):
+            spec[data_bins] = 0
+            if sym % 70 == 6:
+                spec[sync_bins(fftlen)] = t.get_pss(cell_id % 3)
+            else:
+                spec[sync_bins(fftlen)] = sss[sym // 70]
+        x = np.fft.ifft(spec) * np.sqrt(fftlen)
+        cp = ecp_len if sym % 7 == 0 else cp_len
+        res.append(np.concatenate((x[-cp:], x)))
+    return np.concatenate(res)
+
+
+def get_cell_signal(cell_id, start, cfo, amp, nframes, fftlen, rng):
+    frame_len = 10 * 15 * fftlen
+    frames = np.concatenate([mod_frame(cell_id, fftlen, rng) for i in range(nframes + 1)])
+    x = frames[frame_len - start:frame_len - start + nframes * frame_len]
+    return amp * x * np.exp(2j * np.pi * cfo * np.arange(len(x)) / (fftlen * 15e3))
+
+
+class qa_cell_search(gr_unittest.TestCase):
+
+    def test_001_single_cell(self):
+        fftlen = 128
+        rng = np.random.RandomState(42)
+        samps = get_cell_signal(124, 1000, 1200.0, 1.0, 2, fftlen, rng)
+
+        cs = lte.cell_search(fftlen)
+        cells = cs.search(samps.astype(np.complex64).tolist())
+        self.assertEqual(len(cells), 1)
+        self.assertEqual(cells[0].cell_id, 124)
+        self.assertEqual(cells[0].frame_start, 1000)
+        self.assertAlmostEqual(cells[0].cfo, 1200.0, delta=100.0)
+        self.assertTrue(cells[0].snr > 20.0)
+
+    def test_002_neighbours(self):
+        # serving cell plus two weaker neighbours with different timing and CFO
+        fftlen = 128
+        nframes = 4
+        rng = np.random.RandomState(7)
+        exp = [(124, 1000, 1200.0, 1.0), (301, 5000, -3000.0, 0.7), (17, 12345, 500.0, 0.5)]
+        samps = np.zeros(nframes * 10 * 15 * fftlen, dtype=complex)
+        for cell_id, start, cfo, amp in exp:
+            samps += get_cell_signal(cell_id, start, cfo, amp, nframes, fftlen, rng)
+        samps += (rng.randn(len(samps)) + 1j * rng.randn(len(samps))) * np.sqrt(0.01 / 2)
+
+        cs = lte.cell_search(fftlen)
+        cells = cs.search(samps.astype(np.complex64).tolist())
+        self.assertEqual([c.cell_id for c in cells], [e[0] for e in exp])
+        for c, e in zip(cells, exp):
+            self.assertEqual(c.frame_start, e[1])
+            self.assertAlmostEqual(c.cfo, e[2], delta=750.0)
+
+    def test_003_noise(self):
+        fftlen = 128
+        rng = np.random.RandomState(3)
+        n = 2 * 10 * 15 * fftlen
+        samps = (rng.randn(n) + 1j * rng.randn(n)) / np.sqrt(2)
+
+        cs = lte.cell_search(fftlen)
+        self.assertEqual(len(cs.search(samps.astype(np.complex64).tolist())), 0)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_cell_search)
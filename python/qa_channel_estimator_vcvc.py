@@ -155,6 +155,83 @@ class qa_channel_estimator_vcvc (gr_unittest.TestCase):
         src = blocks.vector_source_c(data, False, subcarriers)
         tb2.run()
 
+    def test_004_complex_interp(self):
+        print "test_004_complex_interp BEGIN"
+        N_rb_dl = self.N_rb_dl
+        subcarriers = self.subcarriers
+        cell_id = 124
+        Ncp = 1
+        N_ant = 2
+        style = "tx_diversity"
+        sfn = 0
+
+        stream = self.get_data_stream(N_ant, cell_id, style, N_rb_dl, sfn, subcarriers)
+        data_len = len(stream) / subcarriers
+        tag_list = lte_test.get_tag_list(data_len, self.N_ofdm_symbols, self.tag_key, "source")
+        [rs_pos_frame, rs_val_frame] = lte_test.frame_pilot_value_and_position(N_rb_dl, cell_id, Ncp, 0)
+
+        src = blocks.vector_source_c(stream, False, subcarriers)
+        src.set_data(stream, tag_list)
+        estimator = lte.channel_estimator_vcvc(1, subcarriers, self.tag_key, self.msg_buf_name,
+                                               rs_pos_frame, rs_val_frame, "estimator", True)
+        snk = blocks.vector_sink_c(subcarriers)
+        tb = gr.top_block()
+        tb.connect(src, estimator, snk)
+        tb.run()
+
+        res = snk.data()
+        self.assertTrue(len(res) > 0)
+        expected = [1.0 + 0.0j] * len(res)
+        self.assertComplexTuplesAlmostEqual(res, expected, 5)
+        print "test_004_complex_interp END"
+
+    def test_005_phase_rotation(self):
+        print "test_005_phase_rotation BEGIN"
+        # channel with a linear phase over frequency, i.e. a timing offset.
+        # pilots 6 subcarriers apart are rotated by 0.4 pi against each other.
+        subcarriers = 13
+        n_frame_syms = 2
+        n_syms = 10
+        pos = [0, 6, 12]
+        pilot_carriers = [pos] * n_frame_syms
+        pilot_symbols = [[1.0 + 0.0j] * len(pos)] * n_frame_syms
+        k = np.arange(subcarriers)
+        h = np.exp(1j * 0.4 * np.pi / 6 * k)
+
+        stream = np.tile(h, n_syms).tolist()
+        tag_list = lte_test.get_tag_list(n_syms, n_frame_syms, self.tag_key, "source")
+
+        res = {}
+        for complex_interp in [False, True]:
+            src = blocks.vector_source_c(stream, False, subcarriers, tag_list)
+            estimator = lte.channel_estimator_vcvc(1, subcarriers, self.tag_key, self.msg_buf_name,
+                                                   pilot_carriers, pilot_symbols, "estimator",
+                                                   complex_interp)
+            snk = blocks.vector_sink_c(subcarriers)
+            tb = gr.top_block()
+            tb.connect(src, estimator, snk)
+            tb.run()
+            res[complex_interp] = snk.data()
+            self.assertEqual(len(res[complex_interp]), len(stream))
+
+        # magnitude and phase interpolation follows the rotation exactly.
+        self.assertComplexTuplesAlmostEqual(res[False], stream, 5)
+
+        # complex interpolation cuts the chord between neighbouring pilots.
+        left = np.minimum(k / 6 * 6, 12)
+        right = np.minimum(left + 6, 12)
+        w = (k - left) / 6.0
+        chord = (1 - w) * h[left] + w * h[right]
+        self.assertComplexTuplesAlmostEqual(res[True], np.tile(chord, n_syms).tolist(), 5)
+        # midway between pilots the magnitude drops to cos(0.2 pi) ...
+        mag = np.abs(res[True][:subcarriers])
+        self.assertAlmostEqual(mag[3], np.cos(0.2 * np.pi), 5)
+        self.assertAlmostEqual(mag[9], np.cos(0.2 * np.pi), 5)
+        # ... while both methods agree on the pilots.
+        for p in pos:
+            self.assertComplexAlmostEqual(res[True][p], res[False][p], 5)
+        print "test_005_phase_rotation END"
+
     def get_data_stream(self, N_ant, cell_id, style, N_rb_dl, sfn, subcarriers):
         #mib = lte_test.pack_mib(N_rb_dl, 0, 1.0, 511)
         #bch = lte_test.encode_bch(mib, N_ant)
@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+import lte_swig as lte
+import numpy as np
+
+
+class qa_freq_rotator_cc(gr_unittest.TestCase):
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_001_tag(self):
+        samp_rate = 1.92e6
+        f0 = 1000.0
+        f1 = -2500.0
+        n = 4000
+        switch = 1234
+        data = np.exp(1j * np.arange(n) * 0.01)
+
+        tags = []
+        for offset, freq in [(0, f0), (switch, f1)]:
+            tag = gr.tag_t()
+            tag.offset = offset
+            tag.key = pmt.intern("freq")
+            tag.value = pmt.from_double(freq)
+            tags.append(tag)
+
+        src0 = blocks.vector_source_c(data, False, 1, tags)
+        src1 = blocks.vector_source_c(2 * data, False, 1, tags)
+        rot = lte.freq_rotator_cc(2, samp_rate)
+        snk0 = blocks.vector_sink_c()
+        snk1 = blocks.vector_sink_c()
+        self.tb.connect(src0, (rot, 0), snk0)
+        self.tb.connect(src1, (rot, 1), snk1)
+        self.tb.run()
+
+        # phase is continuous at the frequency switch
+        k = np.arange(n)
+        phase = np.where(k < switch, f0 * k, f0 * switch + f1 * (k - switch))
+        exp = data * np.exp(-2j * np.pi * phase / samp_rate)
+        self.assertComplexTuplesAlmostEqual(exp, snk0.data(), 3)
+        self.assertComplexTuplesAlmostEqual(2 * exp, snk1.data(), 3)
+        self.assertAlmostEqual(rot.freq(), f1)
+
+    def test_002_msg(self):
+        samp_rate = 1.92e6
+        f0 = 7000.0
+        data = np.ones(1000)
+
+        src = blocks.vector_source_c(data, False)
+        rot = lte.freq_rotator_cc(1, samp_rate)
+        snk = blocks.vector_sink_c()
+        rot._post(pmt.intern("freq"), pmt.cons(pmt.from_uint64(0), pmt.from_double(f0)))
+        self.tb.connect(src, rot, snk)
+        self.tb.run()
+
+        exp = np.exp(-2j * np.pi * f0 * np.arange(len(data)) / samp_rate)
+        self.assertComplexTuplesAlmostEqual(exp, snk.data(), 3)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_freq_rotator_cc)
@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# 
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+# 
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+from gnuradio import gr_unittest
+import lte_swig as lte
+from lte_test import pn_generator
+import random
+
+
+class qa_gold_sequence(gr_unittest.TestCase):
+
+    def test_001_bits(self):
+        for c_init in [0, 1, 124, 2 ** 31 - 1] + [random.randint(0, 2 ** 31 - 1) for i in range(10)]:
+            for length in [1, 31, 32, 33, 1920]:
+                self.assertEqual(list(lte.gold_sequence.bits(c_init, length)), pn_generator(length, c_init))
+
+    def test_002_nrz(self):
+        c_init = 124
+        for length in [20, 32, 1920]:
+            ref = [1.0 - 2.0 * c for c in pn_generator(length, c_init)]
+            self.assertFloatTuplesAlmostEqual(lte.gold_sequence.nrz(c_init, length), ref)
+
+    def test_003_words(self):
+        c_init = 4242
+        seq = lte.gold_sequence(c_init)
+        ref = pn_generator(96, c_init)
+        for w in range(3):
+            word = seq.next_word()
+            self.assertEqual([(word >> b) & 1 for b in range(32)], ref[32 * w:32 * (w + 1)])
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_gold_sequence)
@@ -0,0 +1,108 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# 
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+# 
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+from gnuradio import gr_unittest
+import lte_swig as lte
+import lte_test
+import lte_test.lte_phy as t
+import numpy as np
+
+
+def mod_grid(grid, fftlen):
+    # 72 center subcarriers without DC, order as extract_subcarriers_vcvc
+    cp_len = t.lte_core.get_cp_length(fftlen)
+    ecp_len = t.lte_core.get_ecp_length(fftlen)
+    bins = np.array([k - 36 + fftlen if k < 36 else k - 35 for k in range(72)])
+    res = []
+    for sym in range(len(grid)):
+        spec = np.zeros(fftlen, dtype=complex)
+        spec[bins] = grid[sym]
+        x = np.fft.ifft(spec) * np.sqrt(fftlen)
+        cp = ecp_len if sym % 7 == 0 else cp_len
+        res.append(np.concatenate((x[-cp:], x)))
+    return np.concatenate(res)
+
+
+def get_frame(cell_id, N_ant, sfn, fftlen, gains):
+    # reference and sync signals plus the PBCH of frame sfn for each antenna port
+    grid = t.generate_phy_frame(cell_id, 6, N_ant)
+    mib = lte_test.pack_mib(50, 0, 1.0, sfn)
+    bch = lte_test.encode_bch(mib, N_ant)
+    pbch = lte_test.encode_pbch(bch, cell_id, N_ant, "tx_diversity")
+    part = sfn % 4
+    res = 0
+    for ant in range(N_ant):
+        vals = pbch[ant][part * 240:(part + 1) * 240]
+        idx = 0
+        for sym in range(7, 11):
+            for c in range(72):
+                # carriers of reference signals are skipped in symbols 7 and 8
+                if sym < 9 and c % 3 == cell_id % 3:
+                    continue
+                grid[ant][sym][c] = vals[idx]
+                idx += 1
+        res = res + gains[ant] * mod_grid(grid[ant], fftlen)
+    return res
+
+
+class qa_mib_decoder(gr_unittest.TestCase):
+
+    def test_001_1_ant(self):
+        fftlen = 128
+        cell_id = 124
+        samps = get_frame(cell_id, 1, 101, fftlen, [0.8 - 0.6j])
+
+        dec = lte.mib_decoder(fftlen)
+        mib = lte.mib_info()
+        self.assertTrue(dec.decode(mib, samps.astype(np.complex64).tolist(), cell_id, 0.0))
+        self.assertEqual(mib.N_ant, 1)
+        self.assertEqual(mib.N_rb_dl, 50)
+        self.assertEqual(mib.phich_duration, 0)
+        self.assertAlmostEqual(mib.phich_resources, 1.0)
+        self.assertEqual(mib.sfn, 101)
+
+    def test_002_2_ant_cfo(self):
+        fftlen = 256
+        cell_id = 301
+        cfo = -2000.0
+        rng = np.random.RandomState(5)
+        for sfn in [512, 513, 514, 515]:
+            samps = get_frame(cell_id, 2, sfn, fftlen, [1.0, 0.5j])
+            samps = samps * np.exp(2j * np.pi * cfo * np.arange(len(samps)) / (fftlen * 15e3))
+            samps += (rng.randn(len(samps)) + 1j * rng.randn(len(samps))) * np.sqrt(0.05)
+
+            dec = lte.mib_decoder(fftlen)
+            mib = lte.mib_info()
+            self.assertTrue(dec.decode(mib, samps.astype(np.complex64).tolist(), cell_id, cfo))
+            self.assertEqual(mib.N_ant, 2)
+            self.assertEqual(mib.sfn, sfn)
+
+    def test_003_wrong_cell(self):
+        fftlen = 128
+        samps = get_frame(124, 1, 7, fftlen, [1.0])
+        dec = lte.mib_decoder(fftlen)
+        mib = lte.mib_info()
+        self.assertFalse(dec.decode(mib, samps.astype(np.complex64).tolist(), 125, 0.0))
+        self.assertFalse(dec.decode(mib, samps[:1000].astype(np.complex64).tolist(), 124, 0.0))
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_mib_decoder)
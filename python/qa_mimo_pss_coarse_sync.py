@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks, filter
+import pmt
+import lte_swig as lte
+import lte_test.lte_phy as t
+import numpy as np
+
+
+class qa_mimo_pss_coarse_sync(gr_unittest.TestCase):
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_sync(self, samps, rxant, fft_corr, nthreads=1):
+        tb = gr.top_block()
+        sync = lte.mimo_pss_coarse_sync(4, rxant, fft_corr, nthreads)
+        dbg_id = blocks.message_debug()
+        dbg_pos = blocks.message_debug()
+        for rx in range(rxant):
+            tb.connect(blocks.vector_source_c(samps[rx], repeat=False), (sync, rx))
+        tb.msg_connect((sync, 'N_id_2'), (dbg_id, 'store'))
+        tb.msg_connect((sync, 'coarse_pos'), (dbg_pos, 'store'))
+        self.assertEqual(sync.time_to_lock(), -1)
+        tb.run()
+        self.assertTrue(sync.time_to_lock() >= 0)
+        return pmt.to_long(dbg_id.get_message(0)), pmt.to_long(dbg_pos.get_message(0))
+
+    def test_001_fft_corr(self):
+        fftlen = 128
+        rxant = 2
+        taps = filter.optfir.low_pass(1, fftlen * 15e3, 472.5e3, 900e3, 0.2, 40)
+        for cell_id in [124, 125, 126]:
+            samples = t.get_mod_frame(cell_id, 6, 1, fftlen)
+            samps = np.tile(samples[0], 5)
+            # decimate to 64 samples per symbol like the sync flowgraphs
+            samps = np.convolve(samps, taps)[::fftlen / 64]
+            noise = 0.05 * (np.random.randn(rxant, len(samps)) + 1j * np.random.randn(rxant, len(samps)))
+            streams = [(samps + noise[rx]).tolist() for rx in range(rxant)]
+
+            direct = self.run_sync(streams, rxant, False)
+            fft = self.run_sync(streams, rxant, True)
+            self.assertEqual(direct[0], int(cell_id % 3))
+            self.assertEqual(fft, direct)
+            threaded = self.run_sync(streams, rxant, True, rxant)
+            self.assertEqual(threaded, fft)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_mimo_pss_coarse_sync)
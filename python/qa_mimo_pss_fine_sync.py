@@ -0,0 +1,132 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks
+import pmt
+import lte_swig as lte
+import lte_test.lte_phy as t
+import numpy as np
+
+
+class qa_mimo_pss_fine_sync(gr_unittest.TestCase):
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.fftl = fftl = 128
+        self.cpl = 144 * fftl / 2048
+        self.cpl0 = 160 * fftl / 2048
+        self.halffl = 10 * (7 * fftl + 6 * self.cpl + self.cpl0)
+        # PSS start relative to the half frame start
+        self.pss_off = 6 * fftl + 6 * self.cpl + self.cpl0
+        self.rng = np.random.RandomState(42)
+
+    def tearDown(self):
+        self.tb = None
+
+    def get_pss_t(self, N_id_2):
+        # PSS subcarriers -31 ... -1 and 1 ... 31 with unit power in time domain
+        fftl = self.fftl
+        pss_f = np.zeros(fftl, dtype=np.complex)
+        pss = t.get_pss(N_id_2)
+        pss_f[fftl - 31:] = pss[0:31]
+        pss_f[1:32] = pss[31:62]
+        pss_t = np.fft.ifft(pss_f)
+        return pss_t / np.sqrt(np.mean(np.abs(pss_t) ** 2))
+
+    def get_signal(self, N_id_2, start, n_pss, n_noise, snr, delay=None):
+        # n_pss half frames with a PSS and its CP, followed by n_noise half frames of noise only.
+        # With a delay the signal goes through a windowed sinc FIR, which adds 8 samples.
+        pss_t = self.get_pss_t(N_id_2)
+        sym = np.concatenate((pss_t[-self.cpl:], pss_t))
+        samps = np.zeros((n_pss + n_noise) * self.halffl, dtype=np.complex)
+        for h in range(n_pss):
+            pos = h * self.halffl + start + self.pss_off - self.cpl
+            samps[pos:pos + len(sym)] = sym
+        if delay is not None:
+            n = np.arange(17)
+            taps = np.sinc(n - 8 - delay) * np.hamming(17)
+            samps = np.convolve(samps, taps)[0:len(samps)]
+        sigma = np.sqrt(10.0 ** (-snr / 10.0) / 2)
+        samps += sigma * (self.rng.randn(len(samps)) + 1j * self.rng.randn(len(samps)))
+        return samps
+
+    def run_sync(self, samps, N_id_2, coarse_pos):
+        # coarse_pos is given at 64 samples per symbol like from mimo_pss_coarse_sync
+        sync = lte.mimo_pss_fine_sync(self.fftl, 1, 0)
+        dbg_lock = blocks.message_debug()
+        dbg_hf = blocks.message_debug()
+        dbg_frac = blocks.message_debug()
+        self.tb.connect(blocks.vector_source_c(samps.tolist(), False), sync)
+        self.tb.msg_connect((sync, 'lock'), (dbg_lock, 'store'))
+        self.tb.msg_connect((sync, 'half_frame'), (dbg_hf, 'store'))
+        self.tb.msg_connect((sync, 'frac_timing'), (dbg_frac, 'store'))
+        sync._post(pmt.intern('N_id_2'), pmt.from_long(N_id_2))
+        sync._post(pmt.intern('coarse_pos'), pmt.from_long(coarse_pos))
+        self.tb.run()
+        lock = [pmt.to_bool(dbg_lock.get_message(i)) for i in range(dbg_lock.num_messages())]
+        half_frame = [pmt.to_long(dbg_hf.get_message(i)) for i in range(dbg_hf.num_messages())]
+        frac = [pmt.to_double(dbg_frac.get_message(i)) for i in range(dbg_frac.num_messages())]
+        return sync, lock, half_frame, frac
+
+    def test_001_lock(self):
+        N_id_2 = 1
+        start = 1000
+        samps = self.get_signal(N_id_2, start, 6, 8, 20.0)
+        sync, lock, half_frame, frac = self.run_sync(samps, N_id_2, (start + self.pss_off) / (self.fftl / 64))
+
+        # locked on the PSS, lost after 4 half frames of noise
+        self.assertEqual(lock, [True, False])
+        self.assertTrue(sync.lock_quality() < 16.0 / self.fftl)
+        # published on lock and on changes only
+        self.assertEqual(half_frame[0], start)
+        for i in range(1, len(half_frame)):
+            self.assertNotEqual(half_frame[i], half_frame[i - 1])
+
+    def test_002_noise_only(self):
+        # the quality of noise stays below the 16 / fftl floor, lock is lost after 4 half frames
+        samps = self.get_signal(0, 0, 0, 8, 0.0)
+        sync, lock, half_frame, frac = self.run_sync(samps, 0, 2000)
+        self.assertEqual(lock, [True, False])
+        self.assertTrue(sync.lock_quality() < 16.0 / self.fftl)
+
+    def test_003_frac_timing(self):
+        N_id_2 = 2
+        start = 1000
+        n_pss = 6
+        for delay in [0.0, 0.25, 0.5, 0.75]:
+            self.tb = gr.top_block()
+            samps = self.get_signal(N_id_2, start, n_pss, 8, 20.0, delay)
+            # true half frame start, the FIR delays by 8 samples
+            exp = start + 8 + delay
+            coarse_pos = int(round((exp + self.pss_off) / (self.fftl / 64)))
+            sync, lock, half_frame, frac = self.run_sync(samps, N_id_2, coarse_pos)
+
+            # one per tracked PSS, noise half frames until loss of lock follow
+            self.assertTrue(len(frac) >= n_pss - 1)
+            for f in frac:
+                self.assertTrue(0.0 <= f < self.halffl)
+            # parabolic interpolation is biased by less than 0.1 samples here
+            for f in frac[0:n_pss - 1]:
+                self.assertTrue(abs(f - exp) < 0.15)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_mimo_pss_fine_sync)
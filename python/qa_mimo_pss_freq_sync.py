@@ -19,7 +19,7 @@
 # Boston, MA 02110-1301, USA.
 #
 from gnuradio import gr, gr_unittest
-from gnuradio import blocks, filter
+from gnuradio import blocks, filter, analog
 import pmt
 import lte_swig as lte
 import lte_test.lte_phy as t
@@ -51,6 +51,26 @@ class qa_mimo_pss_freq_sync(gr_unittest.TestCase):
         not_res = not_snk.data()
         self.assertEqual(not_res, ())
 
+    def test_002_controller_reacq(self):
+        fftlen = 128
+        period = 4
+        halffl = 75 * fftlen
+        samples = t.get_mod_frame(124, 6, 1, fftlen)
+        samps = np.tile(samples[0], 4)  # 8 half frames
+        src = blocks.vector_source_c(samps, repeat=False, vlen=1)
+        ctrl = lte.mimo_pss_coarse_control(1, fftlen, period)
+        snk = blocks.vector_sink_c(vlen=1)
+
+        # lock followed by loss of lock, only re-acquisition bursts pass
+        ctrl._post(pmt.to_pmt('control'), pmt.PMT_T)
+        ctrl._post(pmt.to_pmt('control'), pmt.PMT_F)
+        self.tb.connect(src, ctrl, snk)
+        self.tb.run()
+
+        res = snk.data()
+        exp = np.concatenate((samps[0:halffl], samps[period * halffl:(period + 1) * halffl]))
+        self.assertComplexTuplesAlmostEqual(exp, res, 5)
+
     def test_001_t(self):
         fftlen = 128
         cell_id = 124
@@ -88,6 +108,60 @@ class qa_mimo_pss_freq_sync(gr_unittest.TestCase):
         #plt.plot(np.abs(samps))
         #plt.show()
 
+    def run_freq_sync(self, N_id_2, fftlen, int_off):
+        # PSS in the last symbol of a slot, subcarriers -31 ... -1 and 1 ... 31
+        pss_f = np.zeros(fftlen, dtype=np.complex)
+        pss = t.get_pss(N_id_2)
+        pss_f[fftlen - 31:] = pss[0:31]
+        pss_f[1:32] = pss[31:62]
+        pss_pos = 6 * fftlen + (6 * 144 + 160) * fftlen / 2048
+        samps = np.zeros(pss_pos + 2 * fftlen, dtype=np.complex)
+        samps[pss_pos:pss_pos + fftlen] = np.fft.ifft(pss_f)
+        # shift by int_off subcarriers
+        samps = samps * np.exp(2j * np.pi * int_off * np.arange(len(samps)) / fftlen)
+
+        # N_id_2 tag at the start of the slot
+        tag = gr.tag_t()
+        tag.offset = 0
+        tag.key = pmt.intern("N_id_2")
+        tag.value = pmt.from_long(N_id_2)
+
+        tb = gr.top_block()
+        src = blocks.vector_source_c(samps.tolist(), False, 1, [tag])
+        sig = analog.sig_source_c(fftlen * 15e3, analog.GR_COS_WAVE, 0, 1)
+        sync = lte.mimo_pss_freq_sync(fftlen, 1, sig)
+        dbg = blocks.message_debug()
+        tb.connect(src, sync)
+        tb.msg_connect((sync, 'freq'), (dbg, 'store'))
+        tb.run()
+
+        self.assertEqual(dbg.num_messages(), 1)
+        freq = pmt.to_double(dbg.get_message(0))
+        self.assertAlmostEqual(sig.frequency(), -freq, 3)
+        return freq
+
+    def test_003_int_freq_off(self):
+        fftlen = 128
+        for N_id_2 in range(3):
+            for int_off in [-2, -1, 1, 2]:
+                freq = self.run_freq_sync(N_id_2, fftlen, int_off)
+                self.assertAlmostEqual(freq, 15000.0 * int_off, 3)
+            # no integer offset, the fractional estimate of a clean PSS is 0
+            freq = self.run_freq_sync(N_id_2, fftlen, 0)
+            self.assertTrue(abs(freq) < 1.0)
+
+    def test_004_int_freq_off_window(self):
+        fftlen = 128
+        for N_id_2 in range(3):
+            # the search window ends at +-5 subcarriers ...
+            for int_off in [-5, 5]:
+                freq = self.run_freq_sync(N_id_2, fftlen, int_off)
+                self.assertAlmostEqual(freq, 15000.0 * int_off, 3)
+            # ... larger offsets are never reported beyond it
+            for int_off in [-6, 6]:
+                freq = self.run_freq_sync(N_id_2, fftlen, int_off)
+                self.assertTrue(abs(freq) <= 15000.0 * 5)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_mimo_pss_freq_sync)
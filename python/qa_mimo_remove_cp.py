@@ -63,6 +63,37 @@ class qa_mimo_remove_cp(gr_unittest.TestCase):
         ref = time_frame.flatten()[0:fftlen * n_syms]
         self.assertComplexTuplesAlmostEqual(res, ref, 5)
 
+    def test_002_demodulate(self):
+        fftlen = 128
+        N_rb_dl = 6
+        N_ant = 2
+        initial_offset = 1459
+        n_slots = 30
+        n_samps = initial_offset + n_slots * t.get_slot_length(fftlen)
+        tag_list = self.get_tag_list(fftlen, initial_offset, n_slots, 10, 'slot', 'pss_tagger')
+
+        # the time domain output of the same block is the reference
+        demod = lte.mimo_remove_cp(fftlen, N_ant, 'symbol', N_rb_dl)
+        rcp = lte.mimo_remove_cp(fftlen, N_ant, 'symbol')
+        snk = blocks.vector_sink_c(12 * N_rb_dl * N_ant)
+        self.tb.connect(demod, snk)
+        ref_snks = []
+        for rx in range(N_ant):
+            samps = np.random.randn(n_samps) + 1j * np.random.randn(n_samps)
+            src = blocks.vector_source_c(samps, tags=tag_list, repeat=False)
+            ref_snks.append(blocks.vector_sink_c(fftlen))
+            self.tb.connect(src, (demod, rx))
+            self.tb.connect(src, (rcp, rx), ref_snks[rx])
+        self.tb.run()
+
+        bins = range(fftlen - 6 * N_rb_dl, fftlen) + range(1, 6 * N_rb_dl + 1)
+        res = np.reshape(snk.data(), (-1, N_ant, 12 * N_rb_dl))
+        for rx in range(N_ant):
+            ref = np.fft.fft(np.reshape(ref_snks[rx].data(), (-1, fftlen)), axis=1)[:, bins]
+            n_syms = min(len(res), len(ref))
+            self.assertTrue(n_syms >= 140)
+            self.assertComplexTuplesAlmostEqual(res[0:n_syms, rx].flatten(), ref[0:n_syms].flatten(), 3)
+
     def get_tag_list(self, fft_len, initial_offset, num_tags, value_range, inkey, srcid):
         slotl = t.get_slot_length(fft_len)
         tl = t.get_tag_list(num_tags, value_range, inkey, srcid)
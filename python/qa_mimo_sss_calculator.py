@@ -678,7 +678,9 @@
 
 from gnuradio import gr, gr_unittest
 from gnuradio import blocks
+import pmt
 import lte_swig as lte
+import lte_test
 
 class qa_mimo_sss_calculator (gr_unittest.TestCase):
 
@@ -690,8 +692,28 @@ class qa_mimo_sss_calculator (gr_unittest.TestCase):
 
     def test_001_t (self):
         # set up fg
+        rxant = 2
+        syms = 10
+        cell_id = 124
+        sss = lte_test.get_sss(cell_id)
+        data = []
+        for n in range(syms):
+            # SSS of subframe 0 and 5 alternate, antennas get the same symbol
+            vec = [0] * 5
+            vec.extend(sss[n % 2])
+            vec.extend([0] * 5)
+            data.extend(vec * rxant)
+
+        src = blocks.vector_source_c(data, False, 72 * rxant)
+        calc = lte.mimo_sss_calculator(rxant)
+        dbg = blocks.message_debug()
+        calc._post(pmt.intern("N_id_2"), pmt.from_long(cell_id % 3))
+        self.tb.connect(src, calc)
+        self.tb.msg_connect((calc, "cell_id"), (dbg, "store"))
         self.tb.run ()
         # check data
+        self.assertEqual(dbg.num_messages(), 1)
+        self.assertEqual(pmt.to_long(dbg.get_message(0)), cell_id)
 
 
 if __name__ == '__main__':
@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+
+from gnuradio import gr, gr_unittest, blocks, fft
+from gnuradio.fft import window
+import lte_swig as lte
+import lte_test as t
+import numpy as np
+import pmt
+
+
+class qa_ofdm_demodulator_cvc(gr_unittest.TestCase):
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def get_input(self, fftl, n_slots, initial_offset, first_slot):
+        slotl = t.get_slot_length(fftl)
+        n = initial_offset + n_slots * slotl
+        samps = np.random.randn(n) + 1j * np.random.randn(n)
+        # slot numbers as tagged by sss_tagger_cc, 0 marks the frame start
+        tags = []
+        for s in range(n_slots):
+            tags.append(t.generate_tag('slot', 'sss_tagger', (first_slot + s) % 20, initial_offset + s * slotl))
+        return samps, tags
+
+    def get_reference(self, samps, fftl, N_rb_dl, frame_start, n_syms):
+        cpl = 144 * fftl // 2048
+        cpl0 = 160 * fftl // 2048
+        bins = range(fftl - 6 * N_rb_dl, fftl) + range(1, 6 * N_rb_dl + 1)
+        ref = []
+        pos = frame_start
+        for i in range(n_syms):
+            pos += cpl0 if i % 7 == 0 else cpl
+            ref.extend(np.fft.fft(samps[pos:pos + fftl])[bins])
+            pos += fftl
+        return ref
+
+    def test_001_t(self):
+        fftl = 128
+        N_rb_dl = 6
+        initial_offset = 1459
+        n_slots = 45
+        first_slot = 3
+        samps, tags = self.get_input(fftl, n_slots, initial_offset, first_slot)
+
+        src = blocks.vector_source_c(samps, tags=tags, repeat=False)
+        demod = lte.ofdm_demodulator_cvc(N_rb_dl, fftl, 'symbol')
+        snk = blocks.vector_sink_c(12 * N_rb_dl)
+        self.tb.connect(src, demod, snk)
+        self.tb.run()
+
+        frame_start = initial_offset + (20 - first_slot) * t.get_slot_length(fftl)
+        res = snk.data()
+        n_syms = len(res) // (12 * N_rb_dl)
+        self.assertTrue(n_syms >= 7 * 20)
+        ref = self.get_reference(samps, fftl, N_rb_dl, frame_start, n_syms)
+        self.assertComplexTuplesAlmostEqual(res, ref, 3)
+
+        # the first symbol of each slot is tagged with its symbol number
+        for tag in snk.tags():
+            self.assertEqual(tag.offset % 7, 0)
+            self.assertEqual(pmt.to_long(tag.value), tag.offset % 140)
+
+    def test_002_t(self):
+        # same output as remove_cp_cvc, fft_vcc and extract_subcarriers_vcvc
+        fftl = 512
+        N_rb_dl = 25
+        samps, tags = self.get_input(fftl, 50, 2000, 11)
+
+        src = blocks.vector_source_c(samps, tags=tags, repeat=False)
+        demod = lte.ofdm_demodulator_cvc(N_rb_dl, fftl, 'symbol')
+        snk = blocks.vector_sink_c(12 * N_rb_dl)
+        self.tb.connect(src, demod, snk)
+
+        rcp = lte.remove_cp_cvc(fftl, 'symbol')
+        fft_vcc = fft.fft_vcc(fftl, True, window.rectangular(fftl), False, 1)
+        ext = lte.extract_subcarriers_vcvc(N_rb_dl, fftl)
+        ref_snk = blocks.vector_sink_c(12 * N_rb_dl)
+        self.tb.connect(src, rcp, fft_vcc, ext, ref_snk)
+        self.tb.run()
+
+        res = snk.data()
+        ref = ref_snk.data()
+        n = min(len(res), len(ref))
+        self.assertTrue(n >= 12 * N_rb_dl * 140)
+        self.assertComplexTuplesAlmostEqual(res[0:n], ref[0:n], 3)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_ofdm_demodulator_cvc)
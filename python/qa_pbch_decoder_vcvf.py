@@ -0,0 +1,141 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2014 Communications Engineering Lab (CEL) / Karlsruhe Institute of Technology (KIT)
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+from gnuradio import gr, gr_unittest, blocks
+import lte_swig as lte
+import numpy as np
+import lte_test
+
+
+class qa_pbch_decoder_vcvf(gr_unittest.TestCase):
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def get_streams(self, n_frames, vlen):
+        np.random.seed(42)
+        streams = []
+        for i in range(3):
+            data = np.random.randn(n_frames * 140 * vlen) + 1j * np.random.randn(n_frames * 140 * vlen)
+            streams.append(data.tolist())
+        # keep channel estimates away from zero
+        streams[1] = [h + 2.0 for h in streams[1]]
+        streams[2] = [h + 2.0j for h in streams[2]]
+        return streams
+
+    def run_decoder(self, streams, tags, N_rb_dl, rxant, cell_id):
+        vlen = 12 * N_rb_dl * rxant
+        srcs = [blocks.vector_source_c(streams[i], False, vlen, tags) for i in range(3)]
+        dec = lte.pbch_decoder_vcvf(N_rb_dl, rxant, "symbol")
+        dec.set_cell_id(cell_id)
+        snk = blocks.vector_sink_f(120)
+        for i in range(3):
+            self.tb.connect(srcs[i], (dec, i))
+        self.tb.connect(dec, snk)
+        self.tb.run()
+        return snk.data()
+
+    def run_per_stage_chain(self, streams, tags, N_rb_dl, rxant, cell_id):
+        # the blocks of lte_pbch_decoder_mimo_2tx up to the soft demodulator
+        vlen = 12 * N_rb_dl * rxant
+        tb = gr.top_block()
+        demux = []
+        for i in range(3):
+            src = blocks.vector_source_c(streams[i], False, vlen, tags)
+            dmx = lte.pbch_demux_vcvc(N_rb_dl, rxant)
+            dmx.set_cell_id(cell_id)
+            tb.connect(src, dmx)
+            demux.append(dmx)
+        pd1 = lte.pre_decoder_vcvc(rxant, 1, 240, "tx_diversity")
+        pd2 = lte.pre_decoder_vcvc(rxant, 2, 240, "tx_diversity")
+        ld1 = lte.layer_demapper_vcvc(1, 240, "tx_diversity")
+        ld2 = lte.layer_demapper_vcvc(2, 240, "tx_diversity")
+        interleave = blocks.interleave(gr.sizeof_gr_complex * 240)
+        demod = lte.qpsk_soft_demod_vcvf(240)
+        snk = blocks.vector_sink_f(480)
+        tb.connect(demux[0], (pd1, 0))
+        tb.connect(demux[1], (pd1, 1))
+        tb.connect(demux[0], (pd2, 0))
+        tb.connect(demux[1], (pd2, 1))
+        tb.connect(demux[2], (pd2, 2))
+        tb.connect(pd1, ld1, (interleave, 0))
+        tb.connect(pd2, ld2, (interleave, 1))
+        tb.connect(interleave, demod, snk)
+        tb.run()
+        return snk.data()
+
+    def descramble(self, soft, cell_id):
+        # same as the lte_pbch_descrambler hier block
+        seq = lte.gold_sequence.nrz(cell_id, 1920)
+        res = []
+        for i in range(len(soft) / 480):
+            part = soft[i * 480:(i + 1) * 480]
+            for p in range(4):
+                scr = [part[k] * seq[p * 480 + k] for k in range(480)]
+                res.extend(scr)
+                res.extend([sum(scr[k + 120 * c] for c in range(4)) / 4.0 for k in range(120)])
+        return res
+
+    def test_001_t(self):
+        cell_id = 124
+        N_rb_dl = 6
+        rxant = 2
+        n_frames = 3
+        vlen = 12 * N_rb_dl * rxant
+
+        streams = self.get_streams(n_frames, vlen)
+        tags = tuple(lte_test.get_tag_list(140 * n_frames, 140, "symbol", "source"))
+
+        res = self.run_decoder(streams, tags, N_rb_dl, rxant, cell_id)
+
+        soft = self.run_per_stage_chain(streams, tags, N_rb_dl, rxant, cell_id)
+        exp_res = self.descramble(soft, cell_id)
+
+        self.assertEqual(len(res), n_frames * 40 * 120)
+        self.assertFloatTuplesAlmostEqual(res, exp_res, 3)
+
+    def test_002_foreign_tags(self):
+        # tags with other keys must not move the PBCH
+        cell_id = 301
+        N_rb_dl = 6
+        rxant = 1
+        n_frames = 2
+        vlen = 12 * N_rb_dl * rxant
+
+        streams = self.get_streams(n_frames, vlen)
+        tags = lte_test.get_tag_list(140 * n_frames, 140, "symbol", "source")
+        exp_res = self.run_decoder(streams, tuple(tags), N_rb_dl, rxant, cell_id)
+
+        foreign = [lte_test.generate_tag("N_id_2", "pss_tagger", 2, 3),
+                   lte_test.generate_tag("slot", "sss_tagger", 0, 5),
+                   lte_test.generate_tag("slot", "sss_tagger", 7, 150)]
+        self.tb = gr.top_block()
+        tags = sorted(foreign + tags, key=lambda tag: tag.offset)
+        res = self.run_decoder(streams, tuple(tags), N_rb_dl, rxant, cell_id)
+
+        self.assertEqual(len(res), n_frames * 40 * 120)
+        self.assertFloatTuplesAlmostEqual(res, exp_res, 5)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_pbch_decoder_vcvf)
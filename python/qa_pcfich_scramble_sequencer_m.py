@@ -20,7 +20,8 @@
 # 
 
 from gnuradio import gr, gr_unittest
-from pcfich_scramble_sequencer_m import pcfich_scramble_sequencer_m
+import lte_swig as lte
+import lte_test
 import pmt
 
 
@@ -28,17 +29,23 @@ class qa_pcfich_scramble_sequencer_m(gr_unittest.TestCase):
     def setUp(self):
         self.tb = gr.top_block()
 
-        self.param = pcfich_scramble_sequencer_m()
+        self.param = lte.pcfich_scramble_sequencer_m()
 
     def tearDown(self):
         self.tb = None
 
     def test_001_t(self):
         cell_id = 47
-        self.param.handle_msg(pmt.from_long(cell_id))
-        # set up fg
-        self.tb.run()
+        table = self.param.descr_table(cell_id)
+
         # check data
+        self.assertEqual(pmt.to_long(pmt.car(table)), 10)
+        seqs = pmt.f32vector_elements(pmt.cdr(table))
+        self.assertEqual(len(seqs), 10 * 32)
+        for ns in range(10):
+            exp = lte_test.nrz_encoding(lte_test.get_pcfich_scrambling_sequence(cell_id, ns))
+            self.assertFloatTuplesAlmostEqual(seqs[32 * ns:32 * (ns + 1)], exp)
+        self.assertTrue(pmt.eq(table, self.param.descr_table(cell_id)))
 
 
 if __name__ == '__main__':
@@ -19,8 +19,11 @@
 # Boston, MA 02110-1301, USA.
 # 
 
-from gnuradio import gr, gr_unittest
+from gnuradio import gr, gr_unittest, blocks
+import pmt
 import lte_swig as lte
+import lte_test.lte_phy as t
+import numpy as np
 
 class qa_rough_symbol_sync_cc (gr_unittest.TestCase):
 
@@ -31,9 +34,50 @@ class qa_rough_symbol_sync_cc (gr_unittest.TestCase):
         self.tb = None
 
     def test_001_t (self):
+        fftl = 128
+        cpl = 144 * fftl // 2048
+        cpl0 = 160 * fftl // 2048
+        samples = t.get_mod_frame(124, 6, 1, fftl)
+        src = blocks.vector_source_c(np.tile(samples[0], 4), False)
+        sync = lte.rough_symbol_sync_cc(fftl, 1)
+        snk = blocks.vector_sink_c()
         # set up fg
+        self.tb.connect(src, sync, snk)
         self.tb.run ()
         # check data
+        tags = snk.tags()
+        sym_tags = [tag for tag in tags if pmt.symbol_to_string(tag.key) == "symbol"]
+        cfo_tags = [tag for tag in tags if pmt.symbol_to_string(tag.key) == "frac_cfo"]
+        # CP start of any symbol in the slot, both windows within the long CP0 are valid
+        starts = [0, cpl0 - cpl] + [cpl0 + fftl + i * (cpl + fftl) for i in range(6)]
+        self.assertTrue(pmt.to_long(sym_tags[-1].value) in starts)
+        self.assertAlmostEqual(pmt.to_double(cfo_tags[-1].value), 0.0, 2)
+
+    def test_002_frac_cfo (self):
+        fftl = 128
+        cpl = 144 * fftl // 2048
+        cpl0 = 160 * fftl // 2048
+        starts = [0, cpl0 - cpl] + [cpl0 + fftl + i * (cpl + fftl) for i in range(6)]
+        samples = np.tile(t.get_mod_frame(124, 6, 1, fftl)[0], 4)
+        for cfo in [-0.3, 0.3]:
+            # rotate by cfo subcarrier spacings
+            rot = np.exp(2j * np.pi * cfo * np.arange(len(samples)) / fftl)
+            src = blocks.vector_source_c((samples * rot).tolist(), False)
+            sync = lte.rough_symbol_sync_cc(fftl, 1)
+            snk = blocks.vector_sink_c()
+            tb = gr.top_block ()
+            tb.connect(src, sync, snk)
+            tb.run ()
+
+            tags = snk.tags()
+            sym_tags = [tag for tag in tags if pmt.symbol_to_string(tag.key) == "symbol"]
+            cfo_tags = [tag for tag in tags if pmt.symbol_to_string(tag.key) == "frac_cfo"]
+            self.assertTrue(len(sym_tags) > 0)
+            self.assertEqual(len(sym_tags), len(cfo_tags))
+            for tag in sym_tags:
+                self.assertTrue(pmt.to_long(tag.value) in starts)
+            for tag in cfo_tags:
+                self.assertAlmostEqual(pmt.to_double(tag.value), cfo, 2)
 
 
 if __name__ == '__main__':
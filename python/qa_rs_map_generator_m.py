@@ -20,8 +20,9 @@
 # 
 
 from gnuradio import gr, gr_unittest, blocks
-from rs_map_generator_m import rs_map_generator_m
+import lte_swig as lte
 import pmt
+import lte_test
 import time
 
 class qa_rs_map_generator_m (gr_unittest.TestCase):
@@ -44,7 +45,7 @@ class qa_rs_map_generator_m (gr_unittest.TestCase):
         self.dbg = blocks.message_debug()
 
         # UUT
-        self.param = rs_map_generator_m(msg_buf_name_in, msg_buf_name_out, N_rb_dl, ant_port)
+        self.param = lte.rs_map_generator_m(msg_buf_name_in, msg_buf_name_out, N_rb_dl, ant_port)
 
         # Set up connections
         self.tb.msg_connect(self.strobe, "strobe", self.param, msg_buf_name_in)
@@ -72,6 +73,26 @@ class qa_rs_map_generator_m (gr_unittest.TestCase):
         #self.tb = None
         return
 
+    def test_002_pilot_map(self):
+        N_rb_dl = 6
+        cell_id = 124
+        Ncp = 1
+        for ant_port in range(4):
+            uut = lte.rs_map_generator_m("cell_id", "pilots", N_rb_dl, ant_port)
+            msg = uut.pilot_map(cell_id)
+            [rs_poss, rs_vals] = lte_test.frame_pilot_value_and_position(N_rb_dl, cell_id, Ncp, ant_port)
+
+            offsets = pmt.s32vector_elements(pmt.nth(0, msg))
+            poss = pmt.s32vector_elements(pmt.nth(1, msg))
+            vals = pmt.c32vector_elements(pmt.nth(2, msg))
+            self.assertEqual(len(offsets), len(rs_poss) + 1)
+            for i in range(len(rs_poss)):
+                self.assertEqual(list(poss[offsets[i]:offsets[i + 1]]), rs_poss[i])
+                self.assertComplexTuplesAlmostEqual(vals[offsets[i]:offsets[i + 1]], rs_vals[i], 5)
+
+            # second request is served from cache
+            self.assertTrue(pmt.eq(msg, uut.pilot_map(cell_id)))
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_rs_map_generator_m)
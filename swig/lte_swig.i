@@ -43,6 +43,16 @@
 #include "lte/mimo_sss_calculator.h"
 #include "lte/mimo_sss_tagger.h"
 #include "lte/mimo_remove_cp.h"
+#include "lte/tail_biting_viterbi.h"
+#include "lte/bch_viterbi_vfvb.h"
+#include "lte/rs_map_generator_m.h"
+#include "lte/gold_sequence.h"
+#include "lte/pcfich_scramble_sequencer_m.h"
+#include "lte/pbch_decoder_vcvf.h"
+#include "lte/freq_rotator_cc.h"
+#include "lte/cell_search.h"
+#include "lte/mib_decoder.h"
+#include "lte/ofdm_demodulator_cvc.h"
 %}
 
 
@@ -117,3 +127,20 @@ GR_SWIG_BLOCK_MAGIC2(lte, mimo_sss_calculator);
 GR_SWIG_BLOCK_MAGIC2(lte, mimo_sss_tagger);
 %include "lte/mimo_remove_cp.h"
 GR_SWIG_BLOCK_MAGIC2(lte, mimo_remove_cp);
+%include "lte/tail_biting_viterbi.h"
+%include "lte/bch_viterbi_vfvb.h"
+GR_SWIG_BLOCK_MAGIC2(lte, bch_viterbi_vfvb);
+%include "lte/rs_map_generator_m.h"
+GR_SWIG_BLOCK_MAGIC2(lte, rs_map_generator_m);
+%include "lte/gold_sequence.h"
+%include "lte/pcfich_scramble_sequencer_m.h"
+GR_SWIG_BLOCK_MAGIC2(lte, pcfich_scramble_sequencer_m);
+%include "lte/pbch_decoder_vcvf.h"
+GR_SWIG_BLOCK_MAGIC2(lte, pbch_decoder_vcvf);
+%include "lte/freq_rotator_cc.h"
+GR_SWIG_BLOCK_MAGIC2(lte, freq_rotator_cc);
+%include "lte/cell_search.h"
+%template(cell_info_vector) std::vector<gr::lte::cell_info>;
+%include "lte/mib_decoder.h"
+%include "lte/ofdm_demodulator_cvc.h"
+GR_SWIG_BLOCK_MAGIC2(lte, ofdm_demodulator_cvc);